@@ -0,0 +1,1002 @@
+/* Start Header **************************************************************/
+/*!
+\file	BenchMain.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+Benchmark of the asteroids update: runs seeded scenarios through the
+simulation step and the sprite batch (with the null flush, where the
+game builds its transforms and draws), and reports the frames per
+second, the 50th and 99th percentile frame times, the heap
+allocations per frame and the memory the instance pool ends up with.
+
+Each scenario is topped up before every frame, outside the timing, so
+it keeps its instance count whatever the collisions destroy. The crowded
+ones play in a world scaled up to keep the asteroids about as far apart
+as in the game, or the ship would lose a life every few frames; the
+batch then views the whole world:
+
+	idle			the round alone: no input, the spawner's asteroids
+	live2048		2048 instances, half bullets, half asteroids, world x10
+	bullets			the ship turning and firing every step, 1536 bullets
+	asteroids		1536 asteroids around the scripted pilot, world x12
+	million			2^20 asteroids around the scripted pilot, world x300,
+					only run when named: give it a few frames
+
+The first BENCH_WARMUP_NUM frames of a scenario are not counted: the
+buffers grow to the scenario's size during them.
+
+The measurements run after the scenarios, each one times a part of the
+update against what it replaced and prints its own lines:
+
+	pool			destroying a random bullet and creating one, with 2047
+					of the old pool's 2048 slots live: the free list against
+					the slot scan gameObjInstCreate did before it
+	layout			the integration over 2k, 64k and 1M instances, on the
+					packed position and velocity arrays against the old
+					instance records
+	grid			the broadphase and rectangle tests of a frame, half
+					bullets half asteroids as dense as live2048, from 512 to
+					128k instances: the grid against brute force, which must
+					find the same hits up to 2k
+	sweep			the same with sort and sweep, its order kept from frame
+					to frame, up to 20k asteroids among 40k instances: past
+					2k the grid is the reference, and the hits must match
+	tree			the same with the AABB tree, its asteroids moved rather
+					than inserted again, up to 64k instances, the grid the
+					reference past 2k
+	transforms		the sprite transforms of 2k and 64k instances: built one
+					by one and in a batch, against the AEMtx33 scale,
+					rotation, translation and two concatenations the game
+					did for every sprite before
+
+A measurement that finds a difference makes the bench return 1.
+
+Usage: asteroids_bench [frames] [seed] [scenario] [broadphase mode]
+       with "scenario" one of the names above, scenario or measurement,
+       all of them by default
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Simulation.h"
+#include "Broadphase.h"
+#include "AABBTree.h"
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const SimBounds		BENCH_BOUNDS			= { -400.0f, -300.0f, 400.0f, 300.0f };	// same world as the 800x600 window
+const unsigned int	BENCH_WARMUP_NUM		= 120;										// frames run before the counting starts
+const float			BENCH_BULLET_SPEED		= 600.0f;
+const float			BENCH_ASTEROID_SPEED	= 60.0f;
+const unsigned int	BENCH_POOL_SLOT_NUM		= 2048;										// slots of the pool before it could grow
+const unsigned int	BENCH_POOL_OP_NUM		= 1 << 20;									// destroy and create pairs timed
+const unsigned int	BENCH_LAYOUT_UPDATE_NUM	= 1 << 26;									// instance updates timed at each size
+const unsigned int	BENCH_BROADPHASE_FRAME_NUM	= 10;									// frames a broadphase scene moves for
+const unsigned int	BENCH_BRUTE_FORCE_MAX	= 2048;										// largest scene brute force is run on
+const unsigned int	BENCH_TRANSFORM_NUM		= 1 << 24;									// transforms built at each size
+const float			BENCH_BULLET_SIZE		= 15.0f;									// sizes of the simulation's
+const float			BENCH_ASTEROID_SIZE		= 100.0f;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct BenchScenario
+{
+	const char *		pName;
+	unsigned int		bulletNum;		// bullets kept alive, from anywhere in the world
+	unsigned int		asteroidNum;	// asteroids kept alive
+	bool				pilot;			// the scripted pilot flies the ship
+	bool				storm;			// the ship turns and fires every step
+	float				worldScale;		// of BENCH_BOUNDS
+	bool				named;			// not part of "all"
+};
+
+struct BenchMeasure
+{
+	const char *		pName;
+	bool				(*pfRun)(unsigned int seed);	// false when what it checks differs
+};
+
+// boxes for the broadphase measurements, the index is the id
+struct BenchBroadphaseScene
+{
+	std::vector<AABB>			boxes;
+	std::vector<AEVec2>			vels;
+	std::vector<AABB>			swept;		// where each box can be during the frame
+	std::vector<unsigned int>	ids;
+	std::vector<unsigned char>	groups;
+};
+
+// instance record and slot scan of gameObjInstCreate before the free list
+struct BenchOldInst
+{
+	void *				pObject;
+	unsigned long		flag;
+	float				scale;
+	AEVec2				posCurr;
+	AEVec2				velCurr;
+	float				dirCurr;
+	AABB				boundingBox;
+	float				transform[3][3];
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static const BenchScenario	sScenarios[] =
+{
+	{ "idle",		0,		0,			false,	false,	1.0f,	false },
+	{ "live2048",	1024,	1023,		false,	false,	10.0f,	false },
+	{ "bullets",	1536,	0,			false,	true,	1.0f,	false },
+	{ "asteroids",	0,		1536,		true,	false,	12.0f,	false },
+	{ "million",	0,		1 << 20,	true,	false,	300.0f,	true },
+};
+
+static unsigned int			sScenarioNum = sizeof(sScenarios) / sizeof(sScenarios[0]);
+
+static bool					benchPool(unsigned int seed);
+static bool					benchLayout(unsigned int seed);
+static bool					benchGrid(unsigned int seed);
+static bool					benchSweep(unsigned int seed);
+static bool					benchTree(unsigned int seed);
+static bool					benchTransforms(unsigned int seed);
+
+static const BenchMeasure	sMeasures[] =
+{
+	{ "pool",		benchPool },
+	{ "layout",		benchLayout },
+	{ "grid",		benchGrid },
+	{ "sweep",		benchSweep },
+	{ "tree",		benchTree },
+	{ "transforms",	benchTransforms },
+};
+
+static unsigned int			sMeasureNum = sizeof(sMeasures) / sizeof(sMeasures[0]);
+
+// heap use of the whole program, read around the timed part of a frame
+static unsigned long		sAllocNum;
+static unsigned long		sAllocBytes;
+
+static unsigned int			sBenchRand;
+static SimBounds			sBenchBounds;		// world of the scenario running
+
+// the measurements add their results here so the compiler keeps the loops
+static volatile float		sBenchSink;
+
+// the pool before the free list
+static BenchOldInst			sBenchOldInstList[BENCH_POOL_SLOT_NUM];
+
+/******************************************************************************/
+/*!
+	Counts every allocation made through new, the containers' included
+*/
+/******************************************************************************/
+void * operator new(size_t size)
+{
+	sAllocNum++;
+	sAllocBytes += (unsigned long)size;
+
+	void * p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+	free(p);
+}
+
+/******************************************************************************/
+/*!
+	Random float in [0, 1), the scenario's own, apart from the simulation's
+*/
+/******************************************************************************/
+static float benchRandFloat(void)
+{
+	sBenchRand = sBenchRand * 1664525u + 1013904223u;
+
+	return (float)(sBenchRand >> 8) * (1.0f / 16777216.0f);
+}
+
+/******************************************************************************/
+/*!
+	Somewhere in the world, going in any direction at "speed"
+*/
+/******************************************************************************/
+static void benchSpawn(unsigned long type, float speed)
+{
+	AEVec2 pos = { sBenchBounds.minX + benchRandFloat() * (sBenchBounds.maxX - sBenchBounds.minX),
+				   sBenchBounds.minY + benchRandFloat() * (sBenchBounds.maxY - sBenchBounds.minY) };
+
+	float dir  = benchRandFloat() * 2.0f * PI;
+	AEVec2 vel = { cosf(dir) * speed, sinf(dir) * speed };
+
+	SimulationSpawn(type, pos, vel);
+}
+
+/******************************************************************************/
+/*!
+	Brings the bullets and asteroids back to the scenario's counts
+*/
+/******************************************************************************/
+static void benchTopUp(const BenchScenario & scenario)
+{
+	unsigned long instNum;
+	const GameObjInstHot & hot = SimulationGetInstances(instNum);
+
+	unsigned int bulletNum = 0, asteroidNum = 0;
+	for (unsigned long i = 0; i < instNum; i++)
+	{
+		bulletNum	+= (hot.type[i] == TYPE_BULLET);
+		asteroidNum	+= (hot.type[i] == TYPE_ASTEROID);
+	}
+
+	for (; bulletNum < scenario.bulletNum; bulletNum++)
+		benchSpawn(TYPE_BULLET, BENCH_BULLET_SPEED);
+
+	for (; asteroidNum < scenario.asteroidNum; asteroidNum++)
+		benchSpawn(TYPE_ASTEROID, BENCH_ASTEROID_SPEED);
+}
+
+/******************************************************************************/
+/*!
+	Input of the ship for one frame
+*/
+/******************************************************************************/
+static SimInput benchInput(const BenchScenario & scenario, unsigned long frame)
+{
+	SimInput input = {};
+
+	if (scenario.storm)
+	{
+		input.left	= true;
+		input.fire	= true;
+	}
+	else if (scenario.pilot)
+	{
+		// the headless runner's pilot
+		input.up	= (frame / 90) % 3 == 0;
+		input.left	= (frame / 45) % 4 == 1;
+		input.right	= (frame / 45) % 4 == 3;
+		input.fire	= frame % 6 == 0;
+	}
+
+	return input;
+}
+
+/******************************************************************************/
+/*!
+	Value at "percent" of the sorted times
+*/
+/******************************************************************************/
+static double benchPercentile(const std::vector<double> & sorted, double percent)
+{
+	size_t index = (size_t)(percent / 100.0 * (double)(sorted.size() - 1) + 0.5);
+
+	return sorted[index];
+}
+
+/******************************************************************************/
+/*!
+	Runs "frameNum" counted frames of the scenario and prints its line
+*/
+/******************************************************************************/
+static void benchRun(const BenchScenario & scenario, unsigned long frameNum, unsigned int seed)
+{
+	sBenchRand = seed ? seed : 1;
+
+	float scale = scenario.worldScale;
+	SimBounds bounds = { BENCH_BOUNDS.minX * scale, BENCH_BOUNDS.minY * scale, BENCH_BOUNDS.maxX * scale, BENCH_BOUNDS.maxY * scale };
+	sBenchBounds = bounds;
+
+	SimulationInit(bounds, seed);
+
+	std::vector<double> frameTimes;
+	frameTimes.reserve(frameNum);
+
+	double			stepTime	= 0.0;
+	double			batchTime	= 0.0;
+	unsigned long	allocNum	= 0;
+	unsigned long	allocBytes	= 0;
+	unsigned long	instSum		= 0;
+	unsigned long	roundNum	= 1;
+
+	for (unsigned long frame = 0; frame < BENCH_WARMUP_NUM + frameNum; frame++)
+	{
+		benchTopUp(scenario);
+
+		SimInput input = benchInput(scenario, frame);
+
+		unsigned long allocNumStart		= sAllocNum;
+		unsigned long allocBytesStart	= sAllocBytes;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		SimulationStep(SIM_DT, input);
+
+		std::chrono::steady_clock::time_point stepEnd = std::chrono::steady_clock::now();
+
+		// what the game's draw does, without the engine
+		unsigned long instNum;
+		const GameObjInstHot & hot = SimulationGetInstances(instNum);
+
+		SpriteBatchBegin(bounds);
+		SpriteBatchAddInstances(hot, instNum, 0.5f);
+		SpriteBatchEnd(SpriteBatchFlushNull);
+
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		if (frame >= BENCH_WARMUP_NUM)
+		{
+			std::chrono::duration<double> step	= stepEnd - start;
+			std::chrono::duration<double> batch	= end - stepEnd;
+
+			frameTimes.push_back((step + batch).count());
+			stepTime	+= step.count();
+			batchTime	+= batch.count();
+			allocNum	+= sAllocNum - allocNumStart;
+			allocBytes	+= sAllocBytes - allocBytesStart;
+			instSum		+= instNum;
+		}
+
+		// restart the round the way the game does on Enter, over the same pool
+		if (SimulationIsOver())
+		{
+			SimulationInit(bounds, seed + (unsigned int)roundNum);
+			roundNum++;
+		}
+	}
+
+	SimPoolInfo pool;
+	SimulationGetPoolInfo(pool);
+
+	SimulationFree();
+
+	double total = stepTime + batchTime;
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	printf("%-10s %10.0f %9.2f %9.2f %9.2f %9.2f %9.2f %9.1f %7.2f %9.1f %6lu %9.0f\n", scenario.pName,
+		   total > 0.0 ? frameNum / total : 0.0,
+		   stepTime * 1.0e6 / frameNum, batchTime * 1.0e6 / frameNum,
+		   benchPercentile(frameTimes, 50.0) * 1.0e6, benchPercentile(frameTimes, 99.0) * 1.0e6,
+		   frameTimes.back() * 1.0e6, (double)instSum / frameNum,
+		   (double)allocNum / frameNum, (double)allocBytes / frameNum, roundNum, pool.bytes / 1024.0);
+}
+
+/******************************************************************************/
+/*!
+	Seconds since "start"
+*/
+/******************************************************************************/
+static double benchSeconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count();
+}
+
+/******************************************************************************/
+/*!
+	gameObjInstCreate before the free list: the first free slot from index 0
+*/
+/******************************************************************************/
+static BenchOldInst * benchOldCreate(const AEVec2 & pos, const AEVec2 & vel, float dir)
+{
+	for (unsigned long i = 0; i < BENCH_POOL_SLOT_NUM; i++)
+	{
+		BenchOldInst * pInst = sBenchOldInstList + i;
+
+		if (pInst->flag == 0)
+		{
+			pInst->flag		= 1;
+			pInst->scale	= 10.0f;
+			pInst->posCurr	= pos;
+			pInst->velCurr	= vel;
+			pInst->dirCurr	= dir;
+
+			return pInst;
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+	A random live bullet destroyed and a new one created, BENCH_POOL_OP_NUM
+	times, with the pool one slot short of full
+*/
+/******************************************************************************/
+static bool benchPool(unsigned int seed)
+{
+	sBenchRand		= seed ? seed : 1;
+	sBenchBounds	= BENCH_BOUNDS;
+
+	SimulationSetCapacity(BENCH_POOL_SLOT_NUM);
+	SimulationInit(BENCH_BOUNDS, seed);
+
+	// the ship takes one slot
+	for (unsigned int i = 1; i < BENCH_POOL_SLOT_NUM - 1; i++)
+		benchSpawn(TYPE_BULLET, BENCH_BULLET_SPEED);
+
+	AEVec2 pos = { 0.0f, 0.0f };
+	AEVec2 vel = { BENCH_BULLET_SPEED, 0.0f };
+
+	unsigned long instNum;
+	SimulationGetInstances(instNum);
+
+	unsigned long allocNumStart = sAllocNum;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (unsigned int op = 0; op < BENCH_POOL_OP_NUM; op++)
+	{
+		// the ship is not despawned, the next one is
+		unsigned long index = (unsigned long)(benchRandFloat() * instNum);
+		if (!SimulationDespawn(index))
+			SimulationDespawn((index + 1) % instNum);
+
+		SimulationSpawn(TYPE_BULLET, pos, vel);
+	}
+
+	double freeListTime = benchSeconds(start);
+	unsigned long allocNum = sAllocNum - allocNumStart;
+
+	SimulationFree();
+	SimulationSetCapacity(GAME_OBJ_INST_NUM_MAX);
+
+	// the same on the old records
+	memset(sBenchOldInstList, 0, sizeof(BenchOldInst) * BENCH_POOL_SLOT_NUM);
+
+	for (unsigned int i = 0; i < BENCH_POOL_SLOT_NUM - 1; i++)
+		benchOldCreate(pos, vel, 0.0f);
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int op = 0; op < BENCH_POOL_OP_NUM; op++)
+	{
+		unsigned long index = (unsigned long)(benchRandFloat() * BENCH_POOL_SLOT_NUM);
+		if (sBenchOldInstList[index].flag == 0)
+			index = (index + 1) % BENCH_POOL_SLOT_NUM;
+
+		sBenchOldInstList[index].flag = 0;
+		sBenchSink = sBenchSink + benchOldCreate(pos, vel, 0.0f)->posCurr.x;
+	}
+
+	double scanTime = benchSeconds(start);
+
+	printf("%-10s %u destroy and create pairs, %u of %u slots live\n", "pool", BENCH_POOL_OP_NUM,
+		   BENCH_POOL_SLOT_NUM - 1, BENCH_POOL_SLOT_NUM);
+	printf("%-10s %-12s %9.1f ns per pair, %lu allocations\n", "", "free list", freeListTime * 1.0e9 / BENCH_POOL_OP_NUM, allocNum);
+	printf("%-10s %-12s %9.1f ns per pair\n", "", "slot scan", scanTime * 1.0e9 / BENCH_POOL_OP_NUM);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	The integration of SimulationStep on its packed arrays, and the one of
+	the game before them on the old records, BENCH_LAYOUT_UPDATE_NUM
+	instance updates each at every size
+*/
+/******************************************************************************/
+static bool benchLayout(unsigned int seed)
+{
+	static const unsigned int sizes[] = { 2048, 65536, 1 << 20 };
+
+	sBenchRand = seed ? seed : 1;
+
+	printf("%-10s %9s %12s %12s   ns per instance update, %u bytes of record against %u of arrays\n", "layout", "instances",
+		   "packed", "records", (unsigned int)sizeof(BenchOldInst), (unsigned int)(4 * sizeof(float)));
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		unsigned int num		= sizes[s];
+		unsigned int passNum	= BENCH_LAYOUT_UPDATE_NUM / num;
+
+		std::vector<float> posX(num), posY(num), velX(num), velY(num);
+		std::vector<BenchOldInst> records(num);
+		memset(&records[0], 0, sizeof(BenchOldInst) * num);
+
+		for (unsigned int i = 0; i < num; i++)
+		{
+			posX[i] = records[i].posCurr.x = benchRandFloat();
+			posY[i] = records[i].posCurr.y = benchRandFloat();
+			velX[i] = records[i].velCurr.x = benchRandFloat();
+			velY[i] = records[i].velCurr.y = benchRandFloat();
+			records[i].flag = 1;
+		}
+
+		float dt = SIM_DT;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (unsigned int pass = 0; pass < passNum; pass++)
+		{
+			for (unsigned long i = 0; i < num; i++)
+			{
+				posX[i] += velX[i] * dt;
+				posY[i] += velY[i] * dt;
+			}
+
+			sBenchSink = sBenchSink + posX[pass % num];
+		}
+
+		double packedTime = benchSeconds(start);
+
+		start = std::chrono::steady_clock::now();
+
+		for (unsigned int pass = 0; pass < passNum; pass++)
+		{
+			for (unsigned long i = 0; i < num; i++)
+			{
+				BenchOldInst * pInst = &records[i];
+
+				if ((pInst->flag & 1) == 0)
+					continue;
+
+				pInst->posCurr.x += pInst->velCurr.x * dt;
+				pInst->posCurr.y += pInst->velCurr.y * dt;
+			}
+
+			sBenchSink = sBenchSink + records[pass % num].posCurr.x;
+		}
+
+		double recordsTime = benchSeconds(start);
+
+		double updateNum = (double)passNum * num;
+
+		printf("%-10s %9u %12.2f %12.2f\n", "", num, packedTime * 1.0e9 / updateNum, recordsTime * 1.0e9 / updateNum);
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	"num" boxes, half bullets (queries) half asteroids (targets), spread
+	over a world that keeps them as far apart as in live2048
+*/
+/******************************************************************************/
+static void benchSceneCreate(BenchBroadphaseScene & scene, unsigned int num, unsigned int seed)
+{
+	sBenchRand = seed ? seed : 1;
+
+	float scale = 10.0f * sqrtf(num / 2048.0f);
+	sBenchBounds.minX = BENCH_BOUNDS.minX * scale;
+	sBenchBounds.minY = BENCH_BOUNDS.minY * scale;
+	sBenchBounds.maxX = BENCH_BOUNDS.maxX * scale;
+	sBenchBounds.maxY = BENCH_BOUNDS.maxY * scale;
+
+	scene.boxes.resize(num);
+	scene.vels.resize(num);
+	scene.swept.resize(num);
+	scene.ids.resize(num);
+	scene.groups.resize(num);
+
+	for (unsigned int i = 0; i < num; i++)
+	{
+		bool bullet = (i % 2) == 0;
+		float size	= bullet ? BENCH_BULLET_SIZE : BENCH_ASTEROID_SIZE;
+		float speed	= bullet ? BENCH_BULLET_SPEED : BENCH_ASTEROID_SPEED;
+
+		float posX	= sBenchBounds.minX + benchRandFloat() * (sBenchBounds.maxX - sBenchBounds.minX);
+		float posY	= sBenchBounds.minY + benchRandFloat() * (sBenchBounds.maxY - sBenchBounds.minY);
+		float dir	= benchRandFloat() * 2.0f * PI;
+
+		scene.boxes[i].min.x	= posX - 0.5f * size;
+		scene.boxes[i].min.y	= posY - 0.5f * size;
+		scene.boxes[i].max.x	= posX + 0.5f * size;
+		scene.boxes[i].max.y	= posY + 0.5f * size;
+		scene.vels[i].x			= cosf(dir) * speed;
+		scene.vels[i].y			= sinf(dir) * speed;
+		scene.ids[i]			= i;
+		scene.groups[i]			= bullet ? BROADPHASE_GROUP_QUERY : BROADPHASE_GROUP_TARGET;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Moves the scene for BENCH_BROADPHASE_FRAME_NUM frames and finds the
+	hits of each through the broadphase "mode" and the rectangle test, as
+	SimulationStep does. "hits" gets the hits of every frame one after the
+	other. Returns the seconds per frame of the broadphase and the tests,
+	the first frame left out: the modes that keep their structure from
+	frame to frame build it then
+*/
+/******************************************************************************/
+static double benchSceneRun(BenchBroadphaseScene & scene, unsigned int mode,
+							std::vector<BroadphasePair> & hits, unsigned long & pairSum)
+{
+	unsigned int num = (unsigned int)scene.boxes.size();
+	std::vector<int> proxies(num, AABB_TREE_NULL);
+
+	double time = 0.0;
+
+	hits.clear();
+	pairSum = 0;
+
+	for (unsigned int frame = 0; frame < BENCH_BROADPHASE_FRAME_NUM; frame++)
+	{
+		for (unsigned int i = 0; i < num; i++)
+			scene.swept[i] = BroadphaseSweptBox(scene.boxes[i], scene.vels[i], SIM_DT);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// the tree is kept up to date by the caller, outside the search
+		if (mode == BROADPHASE_TREE)
+		{
+			for (unsigned int i = 0; i < num; i++)
+			{
+				if (scene.groups[i] != BROADPHASE_GROUP_TARGET)
+					continue;
+
+				AEVec2 displacement = { scene.vels[i].x * SIM_DT, scene.vels[i].y * SIM_DT };
+
+				if (proxies[i] == AABB_TREE_NULL)
+					proxies[i] = AABBTreeCreateProxy(scene.swept[i], i);
+				else
+					AABBTreeMoveProxy(proxies[i], scene.swept[i], displacement);
+			}
+		}
+
+		unsigned int pairNum;
+		const BroadphasePair * pPairs = BroadphaseFindPairs(mode, &scene.swept[0], &scene.ids[0], &scene.groups[0], num, pairNum);
+
+		for (unsigned int p = 0; p < pairNum; p++)
+		{
+			unsigned int query	= pPairs[p].queryId;
+			unsigned int target	= pPairs[p].targetId;
+
+			float tFirst;
+			if (CollisionIntersection_RectRect(scene.boxes[target], scene.vels[target], scene.boxes[query], scene.vels[query], SIM_DT, tFirst))
+				hits.push_back(pPairs[p]);
+		}
+
+		if (frame > 0)
+			time += benchSeconds(start);
+
+		pairSum	+= pairNum;
+
+		for (unsigned int i = 0; i < num; i++)
+		{
+			float dx = scene.vels[i].x * SIM_DT;
+			float dy = scene.vels[i].y * SIM_DT;
+
+			scene.boxes[i].min.x += dx;		scene.boxes[i].max.x += dx;
+			scene.boxes[i].min.y += dy;		scene.boxes[i].max.y += dy;
+		}
+	}
+
+	if (mode == BROADPHASE_TREE)
+		AABBTreeClear();
+
+	return time / (BENCH_BROADPHASE_FRAME_NUM - 1);
+}
+
+/******************************************************************************/
+/*!
+	Runs the same scene through a reference and "mode" at each size and
+	prints their times per frame, both must find the same hits. The
+	reference is brute force up to BENCH_BRUTE_FORCE_MAX and the grid,
+	checked against it on the smaller sizes, past it. The grid itself
+	has no reference past it
+*/
+/******************************************************************************/
+static bool benchBroadphaseCompare(const char * pName, unsigned int mode, const unsigned int * pSizes, unsigned int sizeNum,
+								   unsigned int seed)
+{
+	BenchBroadphaseScene scene;
+	std::vector<BroadphasePair> refHits, hits;
+	unsigned long refSum, pairSum;
+	bool same = true;
+
+	char modeColumn[32];
+	snprintf(modeColumn, sizeof(modeColumn), "%s us", pName);
+
+	printf("%-10s %9s %12s %12s %12s %12s %9s %6s   per frame\n", pName, "instances", "reference", "ref us", modeColumn,
+		   "pairs", "hits", "same");
+
+	for (unsigned int s = 0; s < sizeNum; s++)
+	{
+		unsigned int num = pSizes[s];
+		bool brute = num <= BENCH_BRUTE_FORCE_MAX;
+		bool checked = brute || mode != BROADPHASE_GRID;
+		double refTime = 0.0;
+
+		if (checked)
+		{
+			benchSceneCreate(scene, num, seed);
+			refTime = benchSceneRun(scene, brute ? BROADPHASE_BRUTE_FORCE : BROADPHASE_GRID, refHits, refSum);
+		}
+
+		benchSceneCreate(scene, num, seed);
+		double time = benchSceneRun(scene, mode, hits, pairSum);
+
+		bool sizeSame = !checked || (hits.size() == refHits.size() &&
+									   (hits.empty() || memcmp(&hits[0], &refHits[0], hits.size() * sizeof(BroadphasePair)) == 0));
+		same = same && sizeSame;
+
+		if (checked)
+			printf("%-10s %9u %12s %12.1f %12.1f %12.1f %9.1f %6s\n", "", num, brute ? "brute" : "grid", refTime * 1.0e6,
+				   time * 1.0e6, (double)pairSum / BENCH_BROADPHASE_FRAME_NUM, (double)hits.size() / BENCH_BROADPHASE_FRAME_NUM,
+				   sizeSame ? "yes" : "NO");
+		else
+			printf("%-10s %9u %12s %12s %12.1f %12.1f %9.1f %6s\n", "", num, "-", "-", time * 1.0e6,
+				   (double)pairSum / BENCH_BROADPHASE_FRAME_NUM, (double)hits.size() / BENCH_BROADPHASE_FRAME_NUM, "-");
+	}
+
+	return same;
+}
+
+/******************************************************************************/
+/*!
+	The grid against brute force, and how it scales past it
+*/
+/******************************************************************************/
+static bool benchGrid(unsigned int seed)
+{
+	static const unsigned int sizes[] = { 512, 1024, 2048, 8192, 32768, 131072 };
+
+	return benchBroadphaseCompare("grid", BROADPHASE_GRID, sizes, sizeof(sizes) / sizeof(sizes[0]), seed);
+}
+
+/******************************************************************************/
+/*!
+	Sort and sweep against brute force, and against the grid with 10k and
+	20k asteroids
+*/
+/******************************************************************************/
+static bool benchSweep(unsigned int seed)
+{
+	static const unsigned int sizes[] = { 512, 1024, 2048, 20480, 40960 };
+
+	return benchBroadphaseCompare("sweep", BROADPHASE_SWEEP, sizes, sizeof(sizes) / sizeof(sizes[0]), seed);
+}
+
+/******************************************************************************/
+/*!
+	The AABB tree against brute force, and against the grid up to 32k
+	asteroids
+*/
+/******************************************************************************/
+static bool benchTree(unsigned int seed)
+{
+	static const unsigned int sizes[] = { 512, 1024, 2048, 8192, 32768, 65536 };
+
+	return benchBroadphaseCompare("tree", BROADPHASE_TREE, sizes, sizeof(sizes) / sizeof(sizes[0]), seed);
+}
+
+/******************************************************************************/
+/*!
+	The transform of a sprite the way the game built it before
+	SpriteTransformBuild: three matrices and two concatenations
+*/
+/******************************************************************************/
+static SpriteTransform benchMatrixTransform(float posX, float posY, float scale, float dir)
+{
+	AEMtx33 trans, rot, scaling, transform;
+
+	AEMtx33Scale(&scaling, scale, scale);
+	AEMtx33Rot(&rot, dir);
+	AEMtx33Trans(&trans, posX, posY);
+
+	AEMtx33Concat(&transform, &rot, &scaling);
+	AEMtx33Concat(&transform, &trans, &transform);
+
+	SpriteTransform result;
+	result.c	= transform.m[0][0];
+	result.s	= transform.m[1][0];
+	result.tx	= transform.m[0][2];
+	result.ty	= transform.m[1][2];
+
+	return result;
+}
+
+/******************************************************************************/
+/*!
+	Largest difference of the rotation and scale part of "pTransforms"
+	from "pExpected", relative to the scale
+*/
+/******************************************************************************/
+static float benchTransformError(const SpriteTransform * pTransforms, const SpriteTransform * pExpected,
+								 const float * pScale, unsigned int num)
+{
+	float error = 0.0f;
+
+	for (unsigned int i = 0; i < num; i++)
+	{
+		error = max(error, fabsf(pTransforms[i].c - pExpected[i].c) / pScale[i]);
+		error = max(error, fabsf(pTransforms[i].s - pExpected[i].s) / pScale[i]);
+	}
+
+	return error;
+}
+
+/******************************************************************************/
+/*!
+	BENCH_TRANSFORM_NUM transforms at each size through the three paths
+*/
+/******************************************************************************/
+static bool benchTransforms(unsigned int seed)
+{
+	static const unsigned int sizes[] = { 2048, 65536 };
+
+	sBenchRand = seed ? seed : 1;
+
+	printf("%-10s %9s %12s %12s %12s %12s %12s   ns per transform, error relative to the scale\n", "transforms",
+		   "instances", "matrix", "scalar", "batch", "matrix err", "batch err");
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		unsigned int num		= sizes[s];
+		unsigned int passNum	= BENCH_TRANSFORM_NUM / num;
+
+		std::vector<float> posX(num), posY(num), scale(num), dir(num);
+		std::vector<SpriteTransform> matrix(num), scalar(num), batch(num);
+
+		for (unsigned int i = 0; i < num; i++)
+		{
+			posX[i]		= (benchRandFloat() - 0.5f) * 800.0f;
+			posY[i]		= (benchRandFloat() - 0.5f) * 600.0f;
+			scale[i]	= 15.0f + benchRandFloat() * 85.0f;
+			dir[i]		= (benchRandFloat() * 2.0f - 1.0f) * PI;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (unsigned int pass = 0; pass < passNum; pass++)
+		{
+			for (unsigned int i = 0; i < num; i++)
+				matrix[i] = benchMatrixTransform(posX[i], posY[i], scale[i], dir[i]);
+
+			sBenchSink = sBenchSink + matrix[pass % num].c;
+		}
+
+		double matrixTime = benchSeconds(start);
+
+		start = std::chrono::steady_clock::now();
+
+		for (unsigned int pass = 0; pass < passNum; pass++)
+		{
+			for (unsigned int i = 0; i < num; i++)
+				scalar[i] = SpriteTransformBuild(posX[i], posY[i], scale[i], dir[i]);
+
+			sBenchSink = sBenchSink + scalar[pass % num].c;
+		}
+
+		double scalarTime = benchSeconds(start);
+
+		start = std::chrono::steady_clock::now();
+
+		for (unsigned int pass = 0; pass < passNum; pass++)
+		{
+			SpriteTransformBuildBatch(&posX[0], &posY[0], &scale[0], &dir[0], num, &batch[0]);
+
+			sBenchSink = sBenchSink + batch[pass % num].c;
+		}
+
+		double batchTime = benchSeconds(start);
+
+		double transformNum = (double)passNum * num;
+
+		printf("%-10s %9u %12.2f %12.2f %12.2f %12.1e %12.1e\n", "", num,
+			   matrixTime * 1.0e9 / transformNum, scalarTime * 1.0e9 / transformNum, batchTime * 1.0e9 / transformNum,
+			   benchTransformError(&matrix[0], &scalar[0], &scale[0], num),
+			   benchTransformError(&batch[0], &scalar[0], &scale[0], num));
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the benchmark
+*/
+/******************************************************************************/
+int main(int argc, char ** argv)
+{
+	unsigned long	frameNum	= (argc > 1) ? strtoul(argv[1], nullptr, 10) : 3000;
+	unsigned int	seed		= (argc > 2) ? (unsigned int)strtoul(argv[2], nullptr, 10) : 1;
+	const char *	pScenario	= (argc > 3) ? argv[3] : "all";
+	unsigned int	mode		= (argc > 4) ? (unsigned int)strtoul(argv[4], nullptr, 10) : (unsigned int)BROADPHASE_GRID;
+
+	if (frameNum == 0)
+	{
+		printf("give at least one frame\n");
+		return 1;
+	}
+
+	if (mode >= BROADPHASE_MODE_NUM)
+	{
+		printf("unknown broadphase mode %u\n", mode);
+		return 1;
+	}
+
+	// a texture per type, like the headless runner
+	AtlasRect wholeTexture = { 0.0f, 0.0f, 1.0f, 1.0f };
+	for (unsigned int type = 0; type < TYPE_SIM_NUM; type++)
+		SpriteBatchSetSprite(type, type, wholeTexture, 0, 0);
+
+	SimulationSetBroadphaseMode(mode);
+
+	// the crowded rounds pass the winning score, the round prints on every kill after it
+	std::cout.setstate(std::ios::failbit);
+
+	unsigned int runNum = 0;
+
+	for (unsigned int s = 0; s < sScenarioNum; s++)
+	{
+		bool named = strcmp(pScenario, sScenarios[s].pName) == 0;
+
+		if (!named && (strcmp(pScenario, "all") != 0 || sScenarios[s].named))
+			continue;
+
+		if (runNum == 0)
+		{
+			printf("%lu frames per scenario after %u of warm up, seed %u, %s broadphase\n",
+				   frameNum, BENCH_WARMUP_NUM, seed, BroadphaseModeName(mode));
+			printf("%-10s %10s %9s %9s %9s %9s %9s %9s %7s %9s %6s %9s\n", "scenario", "frames/s",
+				   "step us", "batch us", "p50 us", "p99 us", "max us", "objects", "allocs", "bytes", "rounds", "pool KB");
+		}
+
+		benchRun(sScenarios[s], frameNum, seed);
+		runNum++;
+	}
+
+	if (runNum > 0)
+		printf("step and batch are means, allocs and bytes per frame, pool KB at the end\n");
+
+	unsigned int scenarioRunNum = runNum;
+	bool same = true;
+
+	for (unsigned int m = 0; m < sMeasureNum; m++)
+	{
+		if (strcmp(pScenario, sMeasures[m].pName) != 0 && strcmp(pScenario, "all") != 0)
+			continue;
+
+		if (runNum == scenarioRunNum && runNum > 0)
+			printf("\n");
+
+		same = sMeasures[m].pfRun(seed) && same;
+		runNum++;
+	}
+
+	if (runNum == 0)
+	{
+		printf("unknown scenario %s\n", pScenario);
+		return 1;
+	}
+
+	return same ? 0 : 1;
+}
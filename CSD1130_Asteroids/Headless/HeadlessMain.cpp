@@ -0,0 +1,712 @@
+/* Start Header **************************************************************/
+/*!
+\file	HeadlessMain.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+Headless runner: plays the simulation without the engine, a window or a
+GPU, as fast as it can, for soak and performance runs. A scripted pilot
+turns, thrusts and shoots; a new round starts whenever the ship is out
+of lives. With "batch" set, every frame also goes through the sprite
+batch with the null flush, to measure the batch building; "transform
+mode" picks how it builds the instance transforms (0 one by one, 1 in a
+SIMD batch) so the two can be timed against each other. With "trace
+file" set, the run is captured by the profiler and written there as a
+Chrome trace (see Profile.h).
+
+With "--font", checks the layout of a glyph font instead: the glyphs
+FontPrint queues must fill the size FontGetPrintSize gives, and all the
+text of a frame must be one draw.
+
+With "--load", times the decoding of images the way the game's Load did
+(one after the other) against the background loader (all at once), and
+checks both give the same pixels.
+
+With "--pack", times opening the asset pack and reading every pixel of
+the images in it, as their upload would, against decoding the same
+images from their PNG, and checks both give the same pixels.
+
+With "--collide", checks the SSE2/AVX2 batch collision test against the
+scalar one on hand made edge cases and random boxes: the same hits and
+the same time of first contact, to the bit. It returns 1 when they
+differ, in a release build as well, where the batch test's own check is
+compiled out.
+
+Usage: asteroids_headless [frames] [seed] [broadphase mode] [batch] [transform mode] [trace file]
+       asteroids_headless --font <font description>
+       asteroids_headless --load <image>...
+       asteroids_headless --pack <asset pack> <image>...
+       asteroids_headless --collide [cases] [seed]
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Simulation.h"
+#include "Broadphase.h"
+#include "SpriteBatch.h"
+#include "Font.h"
+#include "Image.h"
+#include "Pack.h"
+#include "Profile.h"
+#include <chrono>
+#include <cfloat>
+#include <cstring>
+#include <utility>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const SimBounds		HEADLESS_BOUNDS			= { -400.0f, -300.0f, 400.0f, 300.0f };	// same world as the 800x600 window
+const unsigned int	HEADLESS_LOAD_RUN_NUM	= 10;										// the best of these is kept
+const unsigned int	HEADLESS_COLLIDE_MAX	= 67;										// largest random batch, its tail goes through the scalar test
+const unsigned int	HEADLESS_COLLIDE_COPY	= 9;										// copies of an edge case in its batch, in the vector part and the tail
+const unsigned int	HEADLESS_COLLIDE_GUARD	= 0xA5A5A5A5u;								// past the hit mask words, must stay
+const unsigned int	HEADLESS_COLLIDE_REPORT	= 10;										// failures printed
+
+/******************************************************************************/
+/*!
+	Input of the scripted pilot for one frame
+*/
+/******************************************************************************/
+static SimInput headlessPilot(unsigned long frame)
+{
+	SimInput input = {};
+
+	input.up	= (frame / 90) % 3 == 0;		// thrust one third of the time
+	input.left	= (frame / 45) % 4 == 1;		// turn one way, then the other
+	input.right	= (frame / 45) % 4 == 3;
+	input.fire	= frame % 6 == 0;				// ten shots a second
+
+	return input;
+}
+
+/******************************************************************************/
+/*!
+	Flush function of the font check: counts the draws and the glyphs
+	and keeps the box around them
+*/
+/******************************************************************************/
+static unsigned int		sFontDrawNum;
+static unsigned int		sFontGlyphNum;
+static SimBounds		sFontInk;
+
+static void headlessFontFlush(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum)
+{
+	UNREFERENCED_PARAMETER(state);
+
+	sFontDrawNum++;
+	sFontGlyphNum += vertexNum / SPRITE_BATCH_QUAD_VERTICES;
+
+	for (unsigned int k = 0; k < vertexNum; k++)
+	{
+		sFontInk.minX = min(sFontInk.minX, pVertices[k].x);
+		sFontInk.minY = min(sFontInk.minY, pVertices[k].y);
+		sFontInk.maxX = max(sFontInk.maxX, pVertices[k].x);
+		sFontInk.maxY = max(sFontInk.maxY, pVertices[k].y);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Prints lines like the HUD's and checks the glyphs against the measured
+	size, one pixel of slack for the glyphs sticking out of their advance.
+	Returns the number of lines that fail
+*/
+/******************************************************************************/
+static int headlessFontCheck(const char * pFileName)
+{
+	if (!FontLoad(pFileName))
+	{
+		printf("cannot read the font %s\n", pFileName);
+		return 1;
+	}
+
+	AtlasRect wholeTexture = { 0.0f, 0.0f, 1.0f, 1.0f };
+	SpriteBatchSetSprite(0, 0, wholeTexture, 0, 0);
+
+	const SimBounds & view = HEADLESS_BOUNDS;
+	// every printable character with ink, the demo font has an empty backslash
+	const char * text[] = { "Ship Left: 3", "Score: 1234567890", "The quick brown fox jumps over the lazy dog", "!\"#$%&'()*+,-./:;<=>?@[]^_`{|}~" };
+	const unsigned int textNum = sizeof(text) / sizeof(text[0]);
+
+	float pixelX	= 2.0f / (view.maxX - view.minX);
+	float pixelY	= 2.0f / (view.maxY - view.minY);
+	float x			= -0.9f;
+	float y			= 0.0f;
+	int failNum		= 0;
+
+	for (unsigned int i = 0; i < textNum; i++)
+	{
+		float width, height;
+		FontGetPrintSize(text[i], 1.0f, view, width, height);
+
+		SimBounds ink = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+		sFontInk		= ink;
+		sFontDrawNum	= 0;
+		sFontGlyphNum	= 0;
+
+		SpriteBatchBegin(view);
+		FontPrint(0, text[i], x, y, 1.0f, view);
+		SpriteBatchEnd(headlessFontFlush);
+
+		unsigned int glyphNum = 0;
+		for (const char * pChar = text[i]; *pChar; pChar++)
+			glyphNum += (*pChar != ' ');
+
+		// the ink in the -1..1 window units
+		float inkMinX	= (sFontInk.minX - view.minX) * pixelX - 1.0f;
+		float inkMaxX	= (sFontInk.maxX - view.minX) * pixelX - 1.0f;
+		float inkHeight	= (sFontInk.maxY - sFontInk.minY) * pixelY;
+
+		bool ok = sFontDrawNum == 1 && sFontGlyphNum == glyphNum &&
+				  fabsf(inkHeight - height) <= 0.01f * pixelY &&
+				  inkMinX >= x - pixelX && inkMaxX <= x + width + pixelX;
+
+		printf("%-45s %2u glyphs, %.4f x %.4f, ink %.4f x %.4f  %s\n", text[i], sFontGlyphNum,
+			   width, height, inkMaxX - inkMinX, inkHeight, ok ? "ok" : "FAILED");
+
+		failNum += !ok;
+	}
+
+	// every line of a frame goes in the same run
+	sFontDrawNum = 0;
+	SpriteBatchBegin(view);
+	for (unsigned int i = 0; i < textNum; i++)
+		FontPrint(0, text[i], x, y - 0.1f * i, 1.0f, view);
+	SpriteBatchEnd(headlessFontFlush);
+
+	printf("%u lines in %u draw\n", textNum, sFontDrawNum);
+	failNum += (sFontDrawNum != 1);
+
+	FontUnload();
+
+	return failNum;
+}
+
+/******************************************************************************/
+/*!
+	Decodes the images one after the other, then on the loader threads,
+	keeping the fastest of a few runs of each. Returns 1 if an image
+	cannot be decoded or the two ways disagree
+*/
+/******************************************************************************/
+static int headlessLoadBench(unsigned int imageNum, char ** ppFileNames)
+{
+	if (imageNum == 0 || imageNum > IMAGE_LOADER_SLOT_MAX)
+	{
+		printf("give 1 to %u images\n", IMAGE_LOADER_SLOT_MAX);
+		return 1;
+	}
+
+	Image sequential[IMAGE_LOADER_SLOT_MAX];
+	double sequentialBest = DBL_MAX, loaderBest = DBL_MAX;
+	int failNum = 0;
+
+	for (unsigned int run = 0; run < HEADLESS_LOAD_RUN_NUM; run++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (unsigned int i = 0; i < imageNum; i++)
+		{
+			// new pixels every run, as the loader threads get
+			Image image;
+			if (!ImageLoadPng(ppFileNames[i], image))
+			{
+				printf("cannot decode %s\n", ppFileNames[i]);
+				return 1;
+			}
+
+			if (run == 0)
+				std::swap(sequential[i], image);
+		}
+
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		sequentialBest = min(sequentialBest, elapsed.count());
+
+		start = std::chrono::steady_clock::now();
+
+		for (unsigned int i = 0; i < imageNum; i++)
+			ImageLoaderStart(i, ppFileNames[i]);
+
+		for (unsigned int i = 0; i < imageNum; i++)
+		{
+			Image * pImage = ImageLoaderWait(i);
+
+			if (run == 0)
+				failNum += !pImage || pImage->width != sequential[i].width ||
+						   pImage->height != sequential[i].height || pImage->pixels != sequential[i].pixels;
+		}
+
+		elapsed = std::chrono::steady_clock::now() - start;
+		loaderBest = min(loaderBest, elapsed.count());
+
+		ImageLoaderFree();
+	}
+
+	for (unsigned int i = 0; i < imageNum; i++)
+		printf("%-50s %4u x %4u\n", ppFileNames[i], sequential[i].width, sequential[i].height);
+
+	printf("one after the other %.2f ms, loader threads %.2f ms (%.2fx), best of %u  %s\n",
+		   sequentialBest * 1000.0, loaderBest * 1000.0, sequentialBest / loaderBest,
+		   HEADLESS_LOAD_RUN_NUM, failNum ? "FAILED" : "ok");
+
+	return failNum ? 1 : 0;
+}
+
+/******************************************************************************/
+/*!
+	Opens the pack and reads the images from it, then decodes them from
+	their PNG, keeping the fastest of a few runs of each. Returns 1 if an
+	image is missing or the two disagree
+*/
+/******************************************************************************/
+static int headlessPackBench(const char * pPackName, unsigned int imageNum, char ** ppFileNames)
+{
+	double packBest = DBL_MAX, pngBest = DBL_MAX;
+	unsigned long byteNum = 0, sum = 0;
+	int failNum = 0;
+
+	for (unsigned int run = 0; run < HEADLESS_LOAD_RUN_NUM; run++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (!PackOpen(pPackName))
+		{
+			printf("cannot open the pack %s\n", pPackName);
+			return 1;
+		}
+
+		// the upload reads every byte, so every page is touched
+		byteNum = 0;
+		sum		= 0;
+		for (unsigned int i = 0; i < imageNum; i++)
+		{
+			PackImage packed;
+			if (!PackFind(ppFileNames[i], packed))
+			{
+				printf("%s is not in the pack\n", ppFileNames[i]);
+				return 1;
+			}
+
+			size_t size = (size_t)packed.width * packed.height * 4;
+			for (size_t b = 0; b < size; b++)
+				sum += packed.pPixels[b];
+
+			byteNum += (unsigned long)size;
+		}
+
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		packBest = min(packBest, elapsed.count());
+
+		// the first run checks the pixels against the decoded ones
+		if (run == 0)
+		{
+			for (unsigned int i = 0; i < imageNum; i++)
+			{
+				PackImage packed;
+				Image image;
+
+				PackFind(ppFileNames[i], packed);
+				failNum += !ImageLoadPng(ppFileNames[i], image) ||
+						   packed.width != image.width || packed.height != image.height ||
+						   memcmp(packed.pPixels, &image.pixels[0], image.pixels.size()) != 0;
+			}
+		}
+
+		PackClose();
+
+		start = std::chrono::steady_clock::now();
+
+		for (unsigned int i = 0; i < imageNum; i++)
+		{
+			Image image;
+			failNum += !ImageLoadPng(ppFileNames[i], image);
+		}
+
+		elapsed = std::chrono::steady_clock::now() - start;
+		pngBest = min(pngBest, elapsed.count());
+	}
+
+	printf("%u images, %lu bytes of pixels (sum %lu)\n", imageNum, byteNum, sum);
+	printf("png %.2f ms, pack %.2f ms (%.1fx), best of %u  %s\n",
+		   pngBest * 1000.0, packBest * 1000.0, pngBest / packBest,
+		   HEADLESS_LOAD_RUN_NUM, failNum ? "FAILED" : "ok");
+
+	return failNum ? 1 : 0;
+}
+
+/******************************************************************************/
+/*!
+	One box against a batch, for the collision check
+*/
+/******************************************************************************/
+struct HeadlessCollideCase
+{
+	AABB				box;
+	AEVec2				vel;
+	AABB				other;
+	AEVec2				otherVel;
+	float				dt;
+};
+
+static const HeadlessCollideCase	sCollideEdgeCases[] =
+{
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 1, 0 }, { 2, 1 } },	{ 0, 0 },		1.0f / 60.0f },	// sides touching, still
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 1, 1 }, { 2, 2 } },	{ 0, 0 },		1.0f / 60.0f },	// corners touching
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 2, 0 }, { 3, 1 } },	{ -60, 0 },		1.0f / 60.0f },	// contact exactly at dt
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 2, 0 }, { 3, 1 } },	{ -59, 0 },		1.0f / 60.0f },	// contact just after dt
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 2, 1 }, { 3, 2 } },	{ -60, 0 },		1.0f / 60.0f },	// sliding along the other's side
+	{ { { 0, 0 }, { 4, 4 } },	{ 3, -2 },	{ { 1, 1 }, { 2, 2 } },	{ 3, -2 },		1.0f / 60.0f },	// inside, same velocity
+	{ { { 0, 0 }, { 1, 1 } },	{ 5, 5 },	{ { 0, 0 }, { 1, 1 } },	{ -5, -5 },		1.0f / 60.0f },	// the same box
+	{ { { 0, 0 }, { 0, 0 } },	{ 0, 0 },	{ { 0, 0 }, { 0, 0 } },	{ 0, 0 },		1.0f / 60.0f },	// two points on each other
+	{ { { 0, 0 }, { 0, 0 } },	{ 60, 0 },	{ { 1, 0 }, { 1, 0 } },	{ 0, 0 },		1.0f / 60.0f },	// a point running into another
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 5, 5 }, { 6, 6 } },	{ -1e30f, -1e30f },	1.0f / 60.0f },	// going through in no time
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 2, 0 }, { 3, 1 } },	{ -600, 0 },	0.0f },			// no time to move
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 0.5f, 0.5f }, { 3, 3 } },	{ 0, 0 },	0.0f },			// overlapping, no time
+	{ { { 0, 0 }, { 1, 1 } },	{ 0, 0 },	{ { 2, 2 }, { 3, 3 } },	{ -1e-30f, -1e-30f },	1.0f },	// tiny velocity, far
+	{ { { -1e6f, -1e6f }, { 1e6f, 1e6f } },	{ 0, 0 },	{ { 1e6f, 0 }, { 2e6f, 1 } },	{ 0, 0 },	1.0f },	// large, touching
+};
+
+static unsigned int		sCollideRand;
+
+/******************************************************************************/
+/*!
+	Random number of the collision check, xorshift32 like the spawner
+*/
+/******************************************************************************/
+static unsigned int headlessCollideRand(void)
+{
+	sCollideRand ^= sCollideRand << 13;
+	sCollideRand ^= sCollideRand >> 17;
+	sCollideRand ^= sCollideRand << 5;
+
+	return sCollideRand;
+}
+
+/******************************************************************************/
+/*!
+	Mostly small whole numbers, so the boxes touch, share sides and stand
+	still along an axis, else any float in [-range, range)
+*/
+/******************************************************************************/
+static float headlessCollideValue(float range)
+{
+	unsigned int pick = headlessCollideRand() % 8;
+
+	if (pick < 3)
+		return (float)((int)(headlessCollideRand() % 9) - 4);
+	if (pick == 3)
+		return 0.0f;
+
+	return ((float)(headlessCollideRand() >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * range;
+}
+
+/******************************************************************************/
+/*!
+	A box, a point now and then
+*/
+/******************************************************************************/
+static AABB headlessCollideBox(void)
+{
+	AABB box;
+	box.min.x = headlessCollideValue(8.0f);
+	box.min.y = headlessCollideValue(8.0f);
+	box.max.x = box.min.x + fabsf(headlessCollideValue(4.0f));
+	box.max.y = box.min.y + fabsf(headlessCollideValue(4.0f));
+
+	return box;
+}
+
+/******************************************************************************/
+/*!
+	Tests "box" against the batch with both tests and prints the first
+	differences. Returns the number of boxes they disagree on
+*/
+/******************************************************************************/
+static unsigned int headlessCollideBatch(const AABB & box, const AEVec2 & vel, const AABBBatch & batch, float dt,
+										 unsigned long & hitSum, unsigned int & reportNum)
+{
+	unsigned int	wordNum = (batch.count + 31) / 32;
+	unsigned int	hitMask[(HEADLESS_COLLIDE_MAX + 31) / 32 + 1];
+	float			tFirst[HEADLESS_COLLIDE_MAX];
+
+	for (unsigned int w = 0; w <= wordNum; w++)
+		hitMask[w] = HEADLESS_COLLIDE_GUARD;
+
+	unsigned int hitNum	= CollisionIntersection_RectRectBatch(box, vel, batch, dt, hitMask, tFirst);
+	unsigned int failNum	= 0;
+	unsigned int scalarHitNum = 0;
+
+	for (unsigned int k = 0; k < batch.count; k++)
+	{
+		AABB	other	= { { batch.minX[k], batch.minY[k] }, { batch.maxX[k], batch.maxY[k] } };
+		AEVec2	otherVel = { batch.velX[k], batch.velY[k] };
+		float	scalarTFirst = 0.0f;
+
+		bool hit		= CollisionIntersection_RectRect(box, vel, other, otherVel, dt, scalarTFirst);
+		bool batchHit	= ((hitMask[k / 32] >> (k % 32)) & 1) != 0;
+
+		scalarHitNum += hit;
+
+		// the same operations in the same order, the times must match to the bit
+		if (hit == batchHit && (!hit || memcmp(&scalarTFirst, &tFirst[k], sizeof(float)) == 0))
+			continue;
+
+		failNum++;
+
+		if (reportNum++ < HEADLESS_COLLIDE_REPORT)
+			printf("box (%g %g)-(%g %g) vel (%g %g) against (%g %g)-(%g %g) vel (%g %g), dt %g: scalar %d t %.9g, batch %d t %.9g\n",
+				   box.min.x, box.min.y, box.max.x, box.max.y, vel.x, vel.y,
+				   other.min.x, other.min.y, other.max.x, other.max.y, otherVel.x, otherVel.y, dt,
+				   hit, scalarTFirst, batchHit, batchHit ? tFirst[k] : 0.0f);
+	}
+
+	// no bit past the boxes, no word past the mask, the right count
+	bool maskOk = hitMask[wordNum] == HEADLESS_COLLIDE_GUARD &&
+				  (batch.count % 32 == 0 || (hitMask[wordNum - 1] >> (batch.count % 32)) == 0);
+
+	if (!maskOk || hitNum != scalarHitNum)
+	{
+		failNum++;
+
+		if (reportNum++ < HEADLESS_COLLIDE_REPORT)
+			printf("batch of %u: %u hits counted for %u, mask %s\n", batch.count, hitNum, scalarHitNum, maskOk ? "ok" : "written past the boxes");
+	}
+
+	hitSum += scalarHitNum;
+
+	return failNum;
+}
+
+/******************************************************************************/
+/*!
+	Runs the edge cases, each copied over the vector part and the tail of
+	its batch, then "caseNum" random batches of 0 to HEADLESS_COLLIDE_MAX
+	boxes. Returns 1 if the two tests disagree anywhere
+*/
+/******************************************************************************/
+static int headlessCollideCheck(unsigned long caseNum, unsigned int seed)
+{
+	std::vector<float> minX(HEADLESS_COLLIDE_MAX), minY(HEADLESS_COLLIDE_MAX), maxX(HEADLESS_COLLIDE_MAX);
+	std::vector<float> maxY(HEADLESS_COLLIDE_MAX), velX(HEADLESS_COLLIDE_MAX), velY(HEADLESS_COLLIDE_MAX);
+
+	unsigned long	boxSum		= 0;
+	unsigned long	hitSum		= 0;
+	unsigned int	failNum		= 0;
+	unsigned int	reportNum	= 0;
+
+	const unsigned int edgeNum = sizeof(sCollideEdgeCases) / sizeof(sCollideEdgeCases[0]);
+
+	// each edge case both ways round
+	for (unsigned int e = 0; e < 2 * edgeNum; e++)
+	{
+		const HeadlessCollideCase & edge = sCollideEdgeCases[e / 2];
+
+		const AABB &	box			= (e % 2) ? edge.other : edge.box;
+		const AEVec2 &	vel			= (e % 2) ? edge.otherVel : edge.vel;
+		const AABB &	other		= (e % 2) ? edge.box : edge.other;
+		const AEVec2 &	otherVel	= (e % 2) ? edge.vel : edge.otherVel;
+
+		for (unsigned int k = 0; k < HEADLESS_COLLIDE_COPY; k++)
+		{
+			minX[k] = other.min.x;	minY[k] = other.min.y;
+			maxX[k] = other.max.x;	maxY[k] = other.max.y;
+			velX[k] = otherVel.x;	velY[k] = otherVel.y;
+		}
+
+		AABBBatch batch = { &minX[0], &minY[0], &maxX[0], &maxY[0], &velX[0], &velY[0], HEADLESS_COLLIDE_COPY };
+		failNum += headlessCollideBatch(box, vel, batch, edge.dt, hitSum, reportNum);
+		boxSum	+= HEADLESS_COLLIDE_COPY;
+	}
+
+	sCollideRand = seed ? seed : 1;
+
+	const float dtList[] = { SIM_DT, 0.0f, 1.0f, 0.25f };
+
+	for (unsigned long c = 0; c < caseNum; c++)
+	{
+		unsigned int count = headlessCollideRand() % (HEADLESS_COLLIDE_MAX + 1);
+
+		for (unsigned int k = 0; k < count; k++)
+		{
+			AABB other = headlessCollideBox();
+
+			minX[k] = other.min.x;	minY[k] = other.min.y;
+			maxX[k] = other.max.x;	maxY[k] = other.max.y;
+			velX[k] = headlessCollideValue(600.0f);
+			velY[k] = headlessCollideValue(600.0f);
+		}
+
+		AABB	box	= headlessCollideBox();
+		AEVec2	vel	= { headlessCollideValue(600.0f), headlessCollideValue(600.0f) };
+		float	dt	= dtList[headlessCollideRand() % (sizeof(dtList) / sizeof(dtList[0]))];
+
+		AABBBatch batch = { &minX[0], &minY[0], &maxX[0], &maxY[0], &velX[0], &velY[0], count };
+		failNum += headlessCollideBatch(box, vel, batch, dt, hitSum, reportNum);
+		boxSum	+= count;
+	}
+
+	printf("%u edge cases and %lu random batches, %lu boxes, %lu hits, %u boxes at a time  %s\n",
+		   2 * edgeNum, caseNum, boxSum, hitSum, CollisionBatchWidth(), failNum ? "FAILED" : "ok");
+
+	return failNum ? 1 : 0;
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the headless runner
+*/
+/******************************************************************************/
+int main(int argc, char ** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--font") == 0)
+		return headlessFontCheck(argc > 2 ? argv[2] : "");
+
+	if (argc > 1 && strcmp(argv[1], "--load") == 0)
+		return headlessLoadBench((unsigned int)(argc - 2), argv + 2);
+
+	if (argc > 2 && strcmp(argv[1], "--pack") == 0)
+		return headlessPackBench(argv[2], (unsigned int)(argc - 3), argv + 3);
+
+	if (argc > 1 && strcmp(argv[1], "--collide") == 0)
+		return headlessCollideCheck((argc > 2) ? strtoul(argv[2], nullptr, 10) : 100000,
+									(argc > 3) ? (unsigned int)strtoul(argv[3], nullptr, 10) : 1);
+
+	unsigned long	frameNum	= (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100000;
+	unsigned int	seed		= (argc > 2) ? (unsigned int)strtoul(argv[2], nullptr, 10) : 1;
+	unsigned int	mode		= (argc > 3) ? (unsigned int)strtoul(argv[3], nullptr, 10) : (unsigned int)BROADPHASE_GRID;
+	bool			batch		= (argc > 4) && strtoul(argv[4], nullptr, 10) != 0;
+	unsigned int	transform	= (argc > 5) ? (unsigned int)strtoul(argv[5], nullptr, 10) : (unsigned int)SPRITE_TRANSFORM_BATCH;
+	const char *	pTraceFile	= (argc > 6) ? argv[6] : nullptr;
+
+	if (mode >= BROADPHASE_MODE_NUM)
+	{
+		printf("unknown broadphase mode %u\n", mode);
+		return 1;
+	}
+
+	if (transform >= SPRITE_TRANSFORM_MODE_NUM)
+	{
+		printf("unknown transform mode %u\n", transform);
+		return 1;
+	}
+
+	// no texture here: each type gets one of its own, like before the
+	// atlas, so the queue has several states to sort into runs
+	AtlasRect wholeTexture = { 0.0f, 0.0f, 1.0f, 1.0f };
+	for (unsigned int type = 0; type < TYPE_SIM_NUM; type++)
+		SpriteBatchSetSprite(type, type, wholeTexture, 0, 0);
+
+	SpriteBatchSetTransformMode(transform);
+	SimulationSetBroadphaseMode(mode);
+	SimulationInit(HEADLESS_BOUNDS, seed);
+
+	unsigned long	roundNum	= 1;
+	unsigned long	scoreSum	= 0;
+	unsigned long	instPeak	= 0;
+	unsigned long	drawSum		= 0;
+	unsigned long	spriteSum	= 0;
+	unsigned long	culledSum	= 0;
+	unsigned long	hitSum		= 0;
+	unsigned long	missSum		= 0;
+	unsigned long	textureSum	= 0;
+	unsigned long	blendSum	= 0;
+	double			batchTime	= 0.0;
+
+	ProfileSetThreadName("Main");
+	if (pTraceFile)
+		ProfileStart();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (unsigned long frame = 0; frame < frameNum; frame++)
+	{
+		PROFILE_ZONE("Frame");
+
+		SimulationStep(SIM_DT, headlessPilot(frame));
+
+		unsigned long instNum;
+		const GameObjInstHot & hot = SimulationGetInstances(instNum);
+		instPeak = max(instPeak, instNum);
+
+		// what the game's draw does, without the engine
+		if (batch)
+		{
+			PROFILE_ZONE("SpriteBatch");
+
+			std::chrono::steady_clock::time_point batchStart = std::chrono::steady_clock::now();
+
+			SpriteBatchBegin(HEADLESS_BOUNDS);
+			SpriteBatchAddInstances(hot, instNum, 0.5f);
+
+			SpriteBatchStats stats = SpriteBatchEnd(SpriteBatchFlushNull);
+			drawSum		+= stats.drawNum;
+			spriteSum	+= stats.spriteNum;
+			culledSum	+= stats.culledNum;
+			hitSum		+= stats.transformHitNum;
+			missSum		+= stats.transformMissNum;
+			textureSum	+= stats.textureChangeNum;
+			blendSum	+= stats.blendChangeNum;
+
+			std::chrono::duration<double> batchElapsed = std::chrono::steady_clock::now() - batchStart;
+			batchTime	+= batchElapsed.count();
+		}
+
+		// restart the round the way the game does on Enter, over the same pool
+		if (SimulationIsOver())
+		{
+			scoreSum += SimulationGetScore();
+			SimulationInit(HEADLESS_BOUNDS, seed + (unsigned int)roundNum);
+			roundNum++;
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	scoreSum += SimulationGetScore();
+
+	if (pTraceFile)
+	{
+		ProfileStop();
+
+		if (!ProfileExport(pTraceFile))
+			printf("cannot write the trace %s\n", pTraceFile);
+	}
+
+	printf("broadphase:   %s\n", BroadphaseModeName(mode));
+	printf("frames:       %lu in %.3f s (%.0f frames/s)\n", frameNum, elapsed.count(),
+		   elapsed.count() > 0.0 ? frameNum / elapsed.count() : 0.0);
+	printf("rounds:       %lu\n", roundNum);
+	printf("score:        %lu\n", scoreSum);
+	printf("peak objects: %lu\n", instPeak);
+
+	SimPoolInfo pool;
+	SimulationGetPoolInfo(pool);
+	printf("pool:         %lu slots in %lu chunks, %.1f KB\n", pool.slotNum, pool.chunkNum, pool.bytes / 1024.0);
+
+	if (batch && frameNum > 0)
+	{
+		printf("sprite batch: %.1f sprites in %.1f draws per frame, %.1f culled\n",
+			   (double)spriteSum / frameNum, (double)drawSum / frameNum, (double)culledSum / frameNum);
+		printf("state changes: %.1f textures, %.1f blend modes per frame\n",
+			   (double)textureSum / frameNum, (double)blendSum / frameNum);
+		printf("transforms:   %.1f reused, %.1f built per frame (%.0f%% hits)\n",
+			   (double)hitSum / frameNum, (double)missSum / frameNum,
+			   hitSum + missSum > 0 ? 100.0 * hitSum / (hitSum + missSum) : 0.0);
+		printf("batch time:   %.3f us per frame, %s transforms\n",
+			   batchTime * 1.0e6 / frameNum, transform == SPRITE_TRANSFORM_BATCH ? "batch" : "scalar");
+	}
+
+	if (pTraceFile)
+		printf("trace:        %s, the last %u zones of each thread\n", pTraceFile, PROFILE_RING_SIZE);
+
+	SimulationFree();
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/* Start Header **************************************************************/
+/*!
+\file	AABBTree.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the dynamic AABB tree holding the long-lived object
+instances (the asteroids), so they can be queried without rebuilding any
+structure every frame.
+
+Each leaf stores a "fat" box: the real box grown by AABB_TREE_MARGIN and
+by the last displacement. A proxy is only re-inserted once its real box
+leaves the fat one.
+
+The functions include:
+\li \c int AABBTreeCreateProxy(const AABB & box, unsigned int id);
+	\n Inserts a leaf for "box" tagged with "id" and returns its proxy.
+
+\li \c void AABBTreeDestroyProxy(int proxy);
+	\n Removes the leaf of the proxy.
+
+\li \c bool AABBTreeMoveProxy(int proxy, const AABB & box, const AEVec2 & displacement);
+	\n Updates the box of the proxy. Returns true if the leaf had to be re-inserted.
+
+\li \c unsigned int AABBTreeQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax);
+	\n Writes the id of every leaf whose fat box overlaps "box" into pResult.
+	\n Returns the number of ids written.
+
+\li \c unsigned int AABBTreeProxyNum(void);
+	\n Returns the number of proxies in the tree, the most a query can return.
+
+\li \c void AABBTreeClear(void);
+	\n Removes every leaf.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_AABB_TREE_H_
+#define CS230_AABB_TREE_H_
+
+#include "Collision.h"
+
+// ---------------------------------------------------------------------------
+
+const float		AABB_TREE_MARGIN		= 10.0f;	// how much a leaf box is grown on each side
+const float		AABB_TREE_DISPLACEMENT	= 2.0f;		// how many frames of displacement the leaf box covers
+const int		AABB_TREE_NULL			= -1;		// no node / no proxy
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+int				AABBTreeCreateProxy(const AABB & box, unsigned int id);
+void			AABBTreeDestroyProxy(int proxy);
+bool			AABBTreeMoveProxy(int proxy, const AABB & box, const AEVec2 & displacement);
+unsigned int	AABBTreeQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax);
+unsigned int	AABBTreeProxyNum(void);
+void			AABBTreeClear(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_AABB_TREE_H_
@@ -0,0 +1,59 @@
+/* Start Header **************************************************************/
+/*!
+\file	Asset.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the asset cache: the textures of the game states,
+kept by file name and counted by the states holding them. A texture
+no state holds any more is not unloaded right away but on the next
+AssetCollect, which Main calls once the next state is loaded, so the
+textures the next state loads again are still there and cost nothing.
+
+The images are taken from the asset pack (see Pack.h) when it is open
+and has them, else decoded on the loader threads (see Image.h), and made
+into textures on the main thread.
+
+The functions include:
+\li \c void AssetTexturePrefetch(const char * pFileName);
+	\n Starts decoding the image in the background, unless it is already a texture or in the pack.
+
+\li \c AEGfxTexture * AssetTextureAcquire(const char * pFileName);
+	\n Returns the texture of the image, made on the first call, and holds it.
+	\n Returns 0 if the image cannot be decoded.
+
+\li \c void AssetTextureRelease(AEGfxTexture * pTexture);
+	\n Stops holding a texture returned by AssetTextureAcquire.
+
+\li \c void AssetCollect(void);
+	\n Unloads the textures no one holds.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_ASSET_H_
+#define CS230_ASSET_H_
+
+#include "AEEngine.h"
+
+// ---------------------------------------------------------------------------
+
+const unsigned int	ASSET_TEXTURE_MAX		= 32;	// textures the cache can hold
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+void				AssetTexturePrefetch(const char * pFileName);
+AEGfxTexture *		AssetTextureAcquire(const char * pFileName);
+void				AssetTextureRelease(AEGfxTexture * pTexture);
+void				AssetCollect(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_ASSET_H_
@@ -0,0 +1,58 @@
+/* Start Header **************************************************************/
+/*!
+\file	Atlas.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the texture atlas description: where each sprite
+sits in the one image all the sprites are packed into. The image and
+its description are made offline by Tools/AtlasPack.py.
+
+The functions include:
+\li \c bool AtlasLoad(const char * pFileName);
+	\n Reads the description. Returns false if the file is missing or malformed.
+
+\li \c const char * AtlasGetImage(void);
+	\n Returns the path of the packed image, in the description's directory.
+
+\li \c bool AtlasFind(const char * pName, AtlasRect & rect);
+	\n Gets the texture coordinates of the named sprite. Returns false if it is not in the atlas.
+
+\li \c void AtlasUnload(void);
+	\n Forgets the description.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_ATLAS_H_
+#define CS230_ATLAS_H_
+
+#include "Platform.h"
+
+// ---------------------------------------------------------------------------
+
+// texture coordinates of a sprite in the atlas, v grows downwards like the
+// image rows: (u0, v0) is the top left corner, (u1, v1) the bottom right one
+struct AtlasRect
+{
+	float			u0, v0;
+	float			u1, v1;
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+bool				AtlasLoad(const char * pFileName);
+const char *		AtlasGetImage(void);
+bool				AtlasFind(const char * pName, AtlasRect & rect);
+void				AtlasUnload(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_ATLAS_H_
@@ -0,0 +1,92 @@
+/* Start Header **************************************************************/
+/*!
+\file	Broadphase.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the broadphase used to find the pairs of object
+instances that are worth a CollisionIntersection_RectRect call.
+
+The functions include:
+\li \c const BroadphasePair * BroadphaseFindPairs(unsigned int mode, const AABB * pBoxes, const unsigned int * pIds, const unsigned char * pGroups, unsigned int count, unsigned int & pairNum);
+	\n Returns the candidate pairs between the query and the target boxes, sorted
+	\n by query id then target id so every mode gives the same order.
+	\n In BROADPHASE_TREE mode the targets come from the AABB tree (see AABBTree.h),
+	\n the target boxes given here are ignored.
+
+\li \c AABB BroadphaseSweptBox(const AABB & box, const AEVec2 & vel, float dt);
+	\n Returns the box that holds "box" over the whole [0, dt] interval.
+
+\li \c void BroadphaseGridBuild(const AABB * pBoxes, const unsigned int * pIds, unsigned int count, float cellSize);
+	\n Rebuilds the uniform grid (spatial hash) from "count" boxes, each tagged with an id.
+
+\li \c unsigned int BroadphaseGridQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax);
+	\n Writes the id of every box sharing a cell with "box" into pResult, each id once.
+	\n Returns the number of ids written.
+
+\li \c void BroadphaseSweepUpdate(const AABB * pBoxes, const unsigned int * pIds, const unsigned char * pGroups, unsigned int count);
+	\n Refreshes the sort and sweep list, which stays sorted along X between frames.
+
+\li \c const BroadphasePair * BroadphaseSweepPairs(unsigned int & pairNum);
+	\n Sweeps the list along X and returns the query/target pairs that overlap.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_BROADPHASE_H_
+#define CS230_BROADPHASE_H_
+
+#include "Collision.h"
+
+// ---------------------------------------------------------------------------
+// broadphase modes, selectable at run time
+
+enum BROADPHASE_MODE
+{
+	BROADPHASE_BRUTE_FORCE = 0,		// every query box against every target box
+	BROADPHASE_GRID,				// uniform grid rebuilt every frame
+	BROADPHASE_SWEEP,				// sort and sweep along X, order kept between frames
+	BROADPHASE_TREE,				// dynamic AABB tree kept up to date by the caller
+
+	BROADPHASE_MODE_NUM
+};
+
+// only pairs made of one query box and one target box are reported
+enum BROADPHASE_GROUP
+{
+	BROADPHASE_GROUP_QUERY = 0,
+	BROADPHASE_GROUP_TARGET
+};
+
+struct BroadphasePair
+{
+	unsigned int	queryId;
+	unsigned int	targetId;
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+const char *			BroadphaseModeName(unsigned int mode);
+const BroadphasePair *	BroadphaseFindPairs(unsigned int mode, const AABB * pBoxes, const unsigned int * pIds,
+											const unsigned char * pGroups, unsigned int count, unsigned int & pairNum);
+
+AABB					BroadphaseSweptBox(const AABB & box, const AEVec2 & vel, float dt);
+
+void					BroadphaseGridBuild(const AABB * pBoxes, const unsigned int * pIds,
+											unsigned int count, float cellSize);
+unsigned int			BroadphaseGridQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax);
+
+void					BroadphaseSweepUpdate(const AABB * pBoxes, const unsigned int * pIds,
+											  const unsigned char * pGroups, unsigned int count);
+const BroadphasePair *	BroadphaseSweepPairs(unsigned int & pairNum);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_BROADPHASE_H_
@@ -12,6 +12,17 @@ The functions include:
 	\n The first argument aabb1 of type AABB holds the information of the bounding box of the first object instance.
 	\n The return type bool should return 0 for No Intersection and 1 for Intersection.
 
+\li \c bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, const AABB & aabb2, const AEVec2 & vel2, float dt, float & tFirst);
+	\n Same test over the [0, dt] interval, "tFirst" gets the time of the first contact.
+
+\li \c unsigned int CollisionIntersection_RectRectBatch(const AABB & aabb1, const AEVec2 & vel1, const AABBBatch & batch, float dt, unsigned int * pHitMask, float * pTFirst);
+	\n Tests "aabb1" against every box of the batch, 4 or 8 boxes at a time with SSE/AVX2.
+	\n Bit i of pHitMask (one word per 32 boxes) is set when box i is hit, pTFirst[i] then
+	\n holds its time of first contact. Returns the number of boxes hit.
+
+\li \c unsigned int CollisionBatchWidth(void);
+	\n Returns the number of boxes the batch test takes at a time: 8 with AVX2, 4 with SSE2, 1 without.
+
 Copyright (C) 20xx DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
 without the prior written consent of DigiPen Institute of
@@ -23,7 +34,7 @@ Technology is prohibited.
 #ifndef CS230_COLLISION_H_
 #define CS230_COLLISION_H_
 
-#include "AEEngine.h"
+#include "Platform.h"
 
 /**************************************************************************/
 /*!
@@ -39,8 +50,36 @@ struct AABB
 	AEVec2	max;
 };
 
+/**************************************************************************/
+/*!
+	Packed boxes and velocities for the batch test, one array per field
+ */
+/**************************************************************************/
+struct AABBBatch
+{
+	const float *	minX;
+	const float *	minY;
+	const float *	maxX;
+	const float *	maxY;
+	const float *	velX;
+	const float *	velY;
+	unsigned int	count;
+};
+
+#if CS230_ALPHA_ENGINE
 bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, 
 									const AABB & aabb2, const AEVec2 & vel2);
+#endif
+
+bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, 
+									const AABB & aabb2, const AEVec2 & vel2,
+									float dt, float & tFirst);
+
+unsigned int CollisionIntersection_RectRectBatch(const AABB & aabb1, const AEVec2 & vel1,
+												 const AABBBatch & batch, float dt,
+												 unsigned int * pHitMask, float * pTFirst);
+
+unsigned int CollisionBatchWidth(void);
 
 
 #endif // CS230_COLLISION_H_
\ No newline at end of file
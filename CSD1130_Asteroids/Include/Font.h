@@ -0,0 +1,58 @@
+/* Start Header **************************************************************/
+/*!
+\file	Font.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the bitmap font: the glyphs of a TrueType font,
+rasterized once by Tools/FontPack.py into one image, and their metrics.
+Text is laid out here and sent to the sprite batch as one quad per
+glyph, so all the text of a frame is drawn in one run.
+
+Positions and sizes are in the units of AEGfxPrint and AEGfxGetPrintSize:
+the window goes from -1 to 1 on both axes, and "y" is the baseline.
+
+The functions include:
+\li \c bool FontLoad(const char * pFileName);
+	\n Reads the glyph metrics. Returns false if the file is missing or malformed.
+
+\li \c const char * FontGetImage(void);
+	\n Returns the path of the glyph image, in the description's directory.
+
+\li \c void FontGetPrintSize(const char * pText, float scale, const SimBounds & view, float & width, float & height);
+	\n Size "pText" takes when printed at "scale" in "view": the sum of the
+	\n advances, and the height of the ink from the lowest glyph to the tallest.
+
+\li \c void FontPrint(unsigned int sprite, const char * pText, float x, float y, float scale, const SimBounds & view);
+	\n Queues the glyphs of "pText" on the sprite batch, as rectangles of "sprite",
+	\n the sprite declared with the glyph image. A '\n' starts a new line.
+
+\li \c void FontUnload(void);
+	\n Forgets the metrics.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_FONT_H_
+#define CS230_FONT_H_
+
+#include "SpriteBatch.h"
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+bool				FontLoad(const char * pFileName);
+const char *		FontGetImage(void);
+void				FontGetPrintSize(const char * pText, float scale, const SimBounds & view, float & width, float & height);
+void				FontPrint(unsigned int sprite, const char * pText, float x, float y, float scale, const SimBounds & view);
+void				FontUnload(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_FONT_H_
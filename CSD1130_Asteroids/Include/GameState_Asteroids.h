@@ -12,25 +12,26 @@ The functions include:
 \li \c void GameStateAsteroidsLoad(void);
 	\n Create the asteroid game object (shape)
 	\n Create the bullet game object (shape)
-	\n Create normalized shapes, which means all the vertices' coordinates in the [-0.5;0.5] range. Use the object instances' scale values to resize the shape. 
+	\n Create normalized shapes, which means all the vertices' coordinates in the [-0.5;0.5] range. Use the object instances' scale values to resize the shape.
+	\n Every sprite comes from one texture atlas, the game objects keep their UV rectangle in it. 
 
 \li \c void GameStateAsteroidsInit(void);
 	\n Create 4 initial asteroids instances with defined positions and velocities.
 	\n Every asteroid have a different size, position, and velocity.
 
 \li \c void GameStateAsteroidsUpdate(void);
-	\n Update the ship's acceleration/velocity/orientation according to user input.
+	\n Turn the user input into a SimInput and step the simulation (see Simulation.h).
 	\n Uses : AEInputCheckCurr: Checks pressed keys.
 	\n		: AEInputCheckTriggered: Checks triggered keys.
 
 \li \c void GameStateAsteroidsDraw(void);
-	\n Draw the object instance using the "AEGfxMeshDraw" function.
+	\n Draw the object instances through the sprite batch, one "AEGfxMeshDraw" per texture.
 
 \li \c void GameStateAsteroidsFree(void);
-	\n Kill each active game object instance using the "gameObjInstDestroy" function.
+	\n Kill each active game object instance using the "SimulationFree" function.
 
 \li \c void GameStateAsteroidsUnload(void);
-	\n Free each used game object (shape) using the "AEGfxMeshFree" function.
+	\n Free each used game object (texture) using the "AEGfxTextureUnload" function.
 
 Copyright (C) 20xx DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
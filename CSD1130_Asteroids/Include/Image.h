@@ -0,0 +1,66 @@
+/* Start Header **************************************************************/
+/*!
+\file	Image.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the image decoder and the background image loader.
+The pixels are decoded here, on any thread, and only handed to the
+engine (AEGfxTextureLoadFromMemory) on the main thread, so the decoding
+of several images can overlap each other and the rest of a Load.
+
+The decoder reads what Tools/AtlasPack.py and Tools/FontPack.py write:
+8-bit RGB or RGBA PNGs, non-interlaced.
+
+The functions include:
+\li \c bool ImageLoadPng(const char * pFileName, Image & image);
+	\n Decodes a PNG into RGBA pixels. Returns false if the file is missing or not supported.
+
+\li \c void ImageLoaderStart(unsigned int slot, const char * pFileName);
+	\n Starts decoding the file into "slot" on a thread of its own.
+
+\li \c Image * ImageLoaderWait(unsigned int slot);
+	\n Waits for the slot's image. Returns 0 if it could not be decoded.
+
+\li \c void ImageLoaderFree(void);
+	\n Waits for every slot, then frees their pixels.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_IMAGE_H_
+#define CS230_IMAGE_H_
+
+#include "Platform.h"
+#include <vector>
+
+// ---------------------------------------------------------------------------
+
+const unsigned int	IMAGE_LOADER_SLOT_MAX	= 8;	// images that can be loading at once
+
+// decoded image, 4 bytes per pixel (red, green, blue, alpha), top row first
+struct Image
+{
+	unsigned int				width;
+	unsigned int				height;
+	std::vector<unsigned char>	pixels;
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+bool				ImageLoadPng(const char * pFileName, Image & image);
+
+void				ImageLoaderStart(unsigned int slot, const char * pFileName);
+Image *				ImageLoaderWait(unsigned int slot);
+void				ImageLoaderFree(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_IMAGE_H_
@@ -21,6 +21,8 @@ Technology is prohibited.
 
 extern float	g_dt;
 extern double	g_appTime;
+extern float	g_simAlpha;		// how far the display is between the last two simulation steps, in [0, 1)
+extern unsigned int	g_simStepNum;	// simulation steps run so far in this display frame
 
 // ---------------------------------------------------------------------------
 // includes
@@ -0,0 +1,59 @@
+/* Start Header **************************************************************/
+/*!
+\file	Pack.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the asset pack: the images of the game, decoded
+offline by Tools/AssetPack.py into one file. The file is mapped in
+memory rather than read, and an image's pixels are used where they are
+in the mapping, so loading one costs the pages its upload touches.
+
+The images are found by the file name of their PNG. The names in the
+pack are relative to the pack's directory, so with the pack opened as
+"../Resources/Assets.pak", "../Resources/Textures/Atlas.png" is found.
+
+The functions include:
+\li \c bool PackOpen(const char * pFileName);
+	\n Maps the pack. Returns false if the file is missing or malformed.
+
+\li \c bool PackFind(const char * pFileName, PackImage & image);
+	\n Gets the decoded pixels of the named image. Returns false if it is not in the pack.
+
+\li \c void PackClose(void);
+	\n Unmaps the pack, the pixels PackFind gave are gone.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_PACK_H_
+#define CS230_PACK_H_
+
+#include "Platform.h"
+
+// ---------------------------------------------------------------------------
+
+// image in the pack, 4 bytes per pixel (red, green, blue, alpha), top row first
+struct PackImage
+{
+	unsigned int			width;
+	unsigned int			height;
+	const unsigned char *	pPixels;		// in the mapping
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+bool				PackOpen(const char * pFileName);
+bool				PackFind(const char * pFileName, PackImage & image);
+void				PackClose(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_PACK_H_
@@ -0,0 +1,169 @@
+/* Start Header **************************************************************/
+/*!
+\file	Platform.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header gives the simulation code (Simulation, Collision, Broadphase,
+AABBTree) the few engine bits it relies on: AEVec2, the assert macros and
+min/max. The headless bench also gets AEMtx33 and the matrix functions
+the game built its sprite transforms with before the sprite batch.
+
+On Windows they come from the Alpha Engine. Elsewhere (the headless
+runner) the same names are defined here so the simulation builds without
+the engine, a window or a GPU.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_PLATFORM_H_
+#define CS230_PLATFORM_H_
+
+#if defined(_WIN32)
+
+// ---------------------------------------------------------------------------
+// the real engine
+
+#include "AEEngine.h"
+
+#define CS230_ALPHA_ENGINE	1
+
+#else
+
+// ---------------------------------------------------------------------------
+// headless build: stand-ins for the engine types and macros
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct AEVec2
+{
+	float x, y;
+}AEVec2;
+
+#ifndef PI
+	#define	PI		3.1415926f
+#endif
+
+#ifndef UNREFERENCED_PARAMETER
+	#define UNREFERENCED_PARAMETER(x)	((void)(x))
+#endif
+
+// row major, a point is transformed as a column vector
+typedef struct AEMtx33
+{
+	float m[3][3];
+}AEMtx33;
+
+inline void AEMtx33Identity(AEMtx33 * pResult)
+{
+	static const AEMtx33 identity = { { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } } };
+	*pResult = identity;
+}
+
+inline void AEMtx33Scale(AEMtx33 * pResult, float x, float y)
+{
+	AEMtx33Identity(pResult);
+	pResult->m[0][0] = x;
+	pResult->m[1][1] = y;
+}
+
+inline void AEMtx33Rot(AEMtx33 * pResult, float angle)
+{
+	float c = cosf(angle);
+	float s = sinf(angle);
+
+	AEMtx33Identity(pResult);
+	pResult->m[0][0] = c;	pResult->m[0][1] = -s;
+	pResult->m[1][0] = s;	pResult->m[1][1] = c;
+}
+
+inline void AEMtx33Trans(AEMtx33 * pResult, float x, float y)
+{
+	AEMtx33Identity(pResult);
+	pResult->m[0][2] = x;
+	pResult->m[1][2] = y;
+}
+
+// pResult = pMtx0 * pMtx1, pResult may be one of them
+inline void AEMtx33Concat(AEMtx33 * pResult, const AEMtx33 * pMtx0, const AEMtx33 * pMtx1)
+{
+	AEMtx33 result;
+
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			result.m[i][j] = pMtx0->m[i][0] * pMtx1->m[0][j] + pMtx0->m[i][1] * pMtx1->m[1][j] + pMtx0->m[i][2] * pMtx1->m[2][j];
+
+	*pResult = result;
+}
+
+#ifndef AE_FINAL
+
+#define AE_ASSERT(x)														\
+{																			\
+	if((x) == 0)															\
+	{																		\
+		printf("AE_ASSERT: %s\nLine: %d\nFunc: %s\nFile: %s\n",				\
+			#x, __LINE__, __FUNCTION__, __FILE__); 							\
+		exit(1);															\
+	}																		\
+}
+
+#define AE_ASSERT_MESG(x, ...)												\
+{																			\
+	if((x) == 0)															\
+	{																		\
+		printf("AE_ASSERT_MESG: %s\nLine: %d\nFunc: %s\nFile: %s\n",		\
+			#x, __LINE__, __FUNCTION__, __FILE__);							\
+		printf("Mesg: ");													\
+		printf(__VA_ARGS__);												\
+		printf("\n");														\
+		exit(1);															\
+	}																		\
+}
+
+#define AE_ASSERT_PARM(x)													\
+{																			\
+	if((x) == 0)															\
+	{																		\
+		printf("AE_ASSERT_PARM: %s\nLine: %d\nFunc: %s\nFile: %s\n",		\
+			#x, __LINE__, __FUNCTION__, __FILE__);							\
+		exit(1);															\
+	}																		\
+}
+
+#else // AE_FINAL
+
+#define AE_ASSERT(x)
+#define AE_ASSERT_MESG(x, ...)
+#define AE_ASSERT_PARM(x)
+
+#endif // AE_FINAL
+
+#define AE_FATAL_ERROR(...)												\
+{																		\
+	printf("AE_FATAL_ERROR: ");											\
+	printf(__VA_ARGS__);												\
+	exit(1);															\
+}
+
+// same behavior as the windows.h macros, as functions so the standard
+// headers can still be included afterwards
+template <typename T> inline T min(T a, T b) { return ((a) < (b)) ? (a) : (b); }
+template <typename T> inline T max(T a, T b) { return ((a) > (b)) ? (a) : (b); }
+
+#define CS230_ALPHA_ENGINE	0
+
+#endif
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_PLATFORM_H_
@@ -0,0 +1,98 @@
+/* Start Header **************************************************************/
+/*!
+\file	Profile.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the CPU profiler: zones of code timed between the
+construction and the destruction of a ProfileZone, recorded while a
+capture runs and written out in the Chrome trace format, to be opened
+in chrome://tracing or ui.perfetto.dev.
+
+Every thread records into a ring buffer of its own, so a zone costs two
+clock reads and a store, and nothing but a flag test when no capture
+runs. A ring keeps the last PROFILE_RING_SIZE zones of its thread.
+
+	void Function(void)
+	{
+		PROFILE_ZONE("Function");			// the whole function
+
+		ProfileZone phase("First");			// phases one after the other
+		...
+		phase.Next("Second");
+		...
+	}
+
+The functions include:
+\li \c void ProfileStart(void);
+	\n Forgets the zones recorded so far and starts recording.
+
+\li \c void ProfileStop(void);
+	\n Stops recording.
+
+\li \c bool ProfileIsCapturing(void);
+	\n Returns true between ProfileStart and ProfileStop.
+
+\li \c void ProfileSetThreadName(const char * pName);
+	\n Names the calling thread in the trace.
+
+\li \c bool ProfileExport(const char * pFileName);
+	\n Writes the recorded zones as a Chrome trace: the caller's and those of the
+	\n threads that have ended, the others are still writing theirs and are left out.
+	\n Returns false if the file cannot be written.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_PROFILE_H_
+#define CS230_PROFILE_H_
+
+#include "Platform.h"
+
+// ---------------------------------------------------------------------------
+
+const unsigned int	PROFILE_RING_SIZE		= 1 << 16;	// zones kept per thread
+const unsigned int	PROFILE_THREAD_MAX		= 16;		// threads recording at once
+
+#define PROFILE_ZONE_NAME2(line)	profileZone##line
+#define PROFILE_ZONE_NAME(line)		PROFILE_ZONE_NAME2(line)
+
+// times the rest of the enclosing scope, "name" must be a string literal
+#define PROFILE_ZONE(name)			ProfileZone PROFILE_ZONE_NAME(__LINE__)(name)
+
+// ---------------------------------------------------------------------------
+
+// a zone, from its construction to its destruction
+struct ProfileZone
+{
+	explicit			ProfileZone(const char * pZoneName);
+						~ProfileZone(void);
+
+	// ends this zone and starts the next one, for the phases of a function
+	void				Next(const char * pNextName);
+
+						ProfileZone(const ProfileZone &) = delete;
+	ProfileZone &		operator=(const ProfileZone &) = delete;
+
+	const char *		pName;
+	long long			begin;			// in ns from the capture start, negative when not recording
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+void				ProfileStart(void);
+void				ProfileStop(void);
+bool				ProfileIsCapturing(void);
+void				ProfileSetThreadName(const char * pName);
+bool				ProfileExport(const char * pFileName);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_PROFILE_H_
@@ -0,0 +1,152 @@
+/* Start Header **************************************************************/
+/*!
+\file	Simulation.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the asteroids simulation: spawning, integration,
+wrapping, collision, scoring and lives. It does not use the engine's
+input, window or frame rate controller, everything comes in through
+SimulationStep, so it also runs headless (see Headless/HeadlessMain.cpp).
+
+The functions include:
+\li \c void SimulationInit(const SimBounds & bounds, unsigned int seed);
+	\n Starts a new round: creates the ship, resets the score and the lives.
+	\n "bounds" is the world rectangle, "seed" seeds the asteroid spawner.
+	\n Called again without SimulationFree, it restarts over the chunks the pool has.
+
+\li \c void SimulationStep(float dt, const SimInput & input);
+	\n Advances the round by one step of "dt" seconds with the given input.
+	\n The game always steps by SIM_DT, so the result does not depend on the display rate.
+
+\li \c void SimulationFree(void);
+	\n Destroys every object instance of the round and frees the pool's chunks.
+
+\li \c const GameObjInstHot & SimulationGetInstances(unsigned long & instNum);
+	\n Returns the packed instances, all "instNum" of them are alive after a step.
+	\n The previous position and direction are kept next to the current ones for interpolation.
+	\n The arrays move when the pool grows, read them again after a step or a spawn.
+
+\li \c bool SimulationSpawn(unsigned long type, const AEVec2 & pos, const AEVec2 & vel);
+	\n Adds a bullet or an asteroid to the round, sized like the round's own.
+	\n Returns false if the pool is at its capacity. For scenarios set up from outside.
+\li \c bool SimulationDespawn(unsigned long index);
+	\n Removes the bullet or asteroid at "index" of the packed arrays at once, the last one takes its place.
+	\n Returns false for the ship or past the instances. For scenarios set up from outside, not during a step.
+
+\li \c void SimulationSetCapacity(unsigned long capacity);
+	\n Sets the number of instances the pool may grow to, GAME_OBJ_INST_NUM_MAX at most.
+	\n The pool never gives back the slots it already has before SimulationFree.
+
+\li \c void SimulationGetPoolInfo(SimPoolInfo & info);
+	\n Fills "info" with the size of the instance pool and the memory it holds.
+
+\li \c void SimulationSetBroadphaseMode(unsigned int mode);
+	\n Selects the BROADPHASE_MODE used by the collision step.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_SIMULATION_H_
+#define CS230_SIMULATION_H_
+
+#include "Platform.h"
+
+// ---------------------------------------------------------------------------
+
+const unsigned int	GAME_OBJ_INST_NUM_MAX		= 1 << 24;		//Most game object instances the pool can grow to, its capacity by default
+const unsigned int	GAME_OBJ_INST_CHUNK_SIZE	= 1024;			//Instances the pool allocates at once, they never move after
+const float			SIM_DT						= 1.0f / 60.0f;	//Fixed step of the simulation, whatever the display rate
+
+// -----------------------------------------------------------------------------
+enum TYPE
+{
+	// list of simulated object types
+	TYPE_SHIP = 0,
+	TYPE_BULLET,
+	TYPE_ASTEROID,
+
+	TYPE_SIM_NUM
+};
+
+// ---------------------------------------------------------------------------
+
+// player input for one frame
+struct SimInput
+{
+	bool				up;			// accelerate forward (held)
+	bool				down;		// accelerate backward (held)
+	bool				left;		// rotate counterclockwise (held)
+	bool				right;		// rotate clockwise (held)
+	bool				fire;		// shoot a bullet (triggered this frame)
+};
+
+// world rectangle, the window in the game
+struct SimBounds
+{
+	float				minX;
+	float				minY;
+	float				maxX;
+	float				maxY;
+};
+
+//Hot fields of the live object instances, stored as one array per field and
+//packed in active list order so the integration loops stream through memory.
+//Each array holds "slotNum" entries
+struct GameObjInstHot
+{
+	float *				posX;		// object current position
+	float *				posY;
+	float *				velX;		// object current velocity
+	float *				velY;
+	float *				scale;		// scaling value of the object instance
+	float *				dir;		// object current direction
+	float *				prevPosX;	// position and direction before the last step,
+	float *				prevPosY;	// the renderer blends them with the current ones
+	float *				prevDir;
+	unsigned long *		shapeStamp;	// new value, never 0, each time scale or dir is written
+	unsigned long *		type;		// TYPE of the instance
+	unsigned long *		slot;		// index of the instance in the simulation's pool
+	unsigned long		slotNum;	// slots of the pool, every "slot" is below it
+};
+
+// size of the object instance pool
+struct SimPoolInfo
+{
+	unsigned long		instNum;	// live instances
+	unsigned long		slotNum;	// instances the pool has room for now
+	unsigned long		chunkNum;	// chunks of GAME_OBJ_INST_CHUNK_SIZE instances allocated
+	unsigned long		capacity;	// instances the pool may grow to
+	size_t				bytes;		// memory held by the pool and the arrays sized after it
+};
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+void					SimulationInit(const SimBounds & bounds, unsigned int seed);
+void					SimulationStep(float dt, const SimInput & input);
+void					SimulationFree(void);
+
+const GameObjInstHot &	SimulationGetInstances(unsigned long & instNum);
+bool					SimulationSpawn(unsigned long type, const AEVec2 & pos, const AEVec2 & vel);
+bool					SimulationDespawn(unsigned long index);
+
+void					SimulationSetCapacity(unsigned long capacity);
+void					SimulationGetPoolInfo(SimPoolInfo & info);
+
+void					SimulationSetBroadphaseMode(unsigned int mode);
+unsigned int			SimulationGetBroadphaseMode(void);
+
+long					SimulationGetLives(void);
+unsigned long			SimulationGetScore(void);
+bool					SimulationIsOver(void);
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_SIMULATION_H_
@@ -0,0 +1,173 @@
+/* Start Header **************************************************************/
+/*!
+\file	SpriteBatch.h
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This header declares the sprite batch: every sprite of a frame is turned
+into a quad already in world space and queued with a 64-bit sort key
+made of its render state (layer, blend mode, texture, mesh). At the end
+of the frame the queue is radix sorted by key and each run of sprites
+sharing a state is handed to a flush function in one go, so a frame
+costs one draw call per state instead of one per sprite. Sprites whose
+bounding box is outside the view are dropped before they are
+transformed.
+
+A sprite is a texture and a rectangle of it, so sprites packed into one
+atlas (see Atlas.h) all land in the same run.
+
+The functions include:
+\li \c void SpriteBatchSetSprite(unsigned int sprite, unsigned int texture, const AtlasRect & rect, unsigned int layer, unsigned int blend);
+	\n Declares which texture, and which part of it, the sprite is drawn with,
+	\n in which layer (higher layers are drawn on top) and with which blend mode.
+
+\li \c void SpriteBatchBegin(const SimBounds & view);
+	\n Empties the queue for a new frame seen through the "view" rectangle.
+
+\li \c void SpriteBatchAdd(unsigned int sprite, float posX, float posY, float scale, float dir);
+	\n Queues the unit quad scaled by "scale", rotated by "dir" and moved to (posX, posY),
+	\n unless it is out of the view.
+
+\li \c void SpriteBatchAddRect(unsigned int sprite, float minX, float minY, float maxX, float maxY, const AtlasRect & rect);
+	\n Queues an axis aligned rectangle showing "rect" of the sprite's texture, in the
+	\n sprite's state. The font draws its glyphs with it.
+
+\li \c void SpriteBatchAddInstances(const GameObjInstHot & hot, unsigned long instNum, float alpha);
+	\n Queues every simulated instance, "alpha" of the way between its previous
+	\n and current state. The sprite of an instance is its type. The rotation and
+	\n scale of a transform are kept until the instance's shape stamp changes; the
+	\n transforms that are not kept are built together, see SpriteBatchSetTransformMode.
+
+\li \c void SpriteBatchSetTransformMode(unsigned int mode);
+	\n Builds the instance transforms one by one or with SpriteTransformBuildBatch.
+
+\li \c SpriteTransform SpriteTransformBuild(float posX, float posY, float scale, float dir);
+	\n Writes the transform of a sprite directly, without going through three
+	\n matrices and two concatenations.
+
+\li \c void SpriteTransformBuildBatch(const float * pPosX, const float * pPosY, const float * pScale, const float * pDir, unsigned int num, SpriteTransform * pTransforms);
+	\n SpriteTransformBuild over arrays, 4 at a time with SSE2. Its sine and
+	\n cosine are polynomials, within a few ulps of the library ones.
+
+\li \c SpriteBatchStats SpriteBatchEnd(SpriteBatchFlushFn pfFlush);
+	\n Sorts the queue and calls pfFlush once per run of sprites with the same state.
+	\n Sprites with the same state keep the order they were added in.
+
+\li \c void SpriteBatchFlushNull(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum);
+	\n Flush function that draws nothing, to measure the batch building headless.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+
+#ifndef CS230_SPRITE_BATCH_H_
+#define CS230_SPRITE_BATCH_H_
+
+#include "Simulation.h"
+#include "Atlas.h"
+
+// ---------------------------------------------------------------------------
+
+const unsigned int	SPRITE_BATCH_TEXTURE_MAX	= 32;	// textures a batch can sort the sprites into
+const unsigned int	SPRITE_BATCH_SPRITE_MAX		= 32;	// sprites that can be declared
+const unsigned int	SPRITE_BATCH_QUAD_VERTICES	= 6;	// a quad is sent as two triangles
+const unsigned int	SPRITE_BATCH_RUN_MAX		= SPRITE_BATCH_SPRITE_MAX;	// runs of a frame: at most one per sprite
+const unsigned int	SPRITE_BATCH_MESH_QUAD		= 0;	// mesh of the sort key: every sprite is the unit quad
+
+// state changes between two runs
+const unsigned int	SPRITE_BATCH_CHANGE_TEXTURE	= 0x00000001;
+const unsigned int	SPRITE_BATCH_CHANGE_BLEND	= 0x00000002;
+
+// how SpriteBatchAddInstances builds the transforms
+enum SPRITE_TRANSFORM_MODE
+{
+	SPRITE_TRANSFORM_SCALAR = 0,	// SpriteTransformBuild per instance
+	SPRITE_TRANSFORM_BATCH,			// SpriteTransformBuildBatch over the instances in view
+
+	SPRITE_TRANSFORM_MODE_NUM
+};
+
+// scale, then rotate, then translate, as one 2x3 matrix:
+//	| c  -s  tx |
+//	| s   c  ty |
+struct SpriteTransform
+{
+	float				c, s;		// cosine and sine of the angle, times the scale
+	float				tx, ty;		// position
+};
+
+// one corner of a pre-transformed quad
+struct SpriteVertex
+{
+	float				x, y;		// world position
+	float				u, v;		// texture coordinates
+};
+
+// render state of a run of sprites, the fields of the sort key
+struct SpriteBatchState
+{
+	unsigned int		layer;		// 8 bits, most significant
+	unsigned int		blend;		// 8 bits, the engine's blend mode
+	unsigned int		texture;	// 16 bits
+	unsigned int		mesh;		// 16 bits
+	unsigned int		run;		// index of the run in the frame
+	unsigned int		changed;	// SPRITE_BATCH_CHANGE_ bits since the previous run, all set for the first one
+};
+
+// what one frame of batching cost, kept to track regressions
+struct SpriteBatchStats
+{
+	unsigned int		drawNum;			// flush calls, one per run
+	unsigned int		spriteNum;			// quads sent
+	unsigned int		culledNum;			// quads dropped out of the view
+	unsigned int		transformHitNum;	// instance transforms reused from an earlier frame
+	unsigned int		transformMissNum;	// instance transforms built
+	unsigned int		textureChangeNum;	// runs that bind another texture, the first one included
+	unsigned int		blendChangeNum;		// runs that set another blend mode, the first one included
+};
+
+// draws "vertexNum" vertices (vertexNum / 3 triangles) with the given state
+typedef void (*SpriteBatchFlushFn)(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum);
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+
+void				SpriteBatchSetSprite(unsigned int sprite, unsigned int texture, const AtlasRect & rect,
+										 unsigned int layer, unsigned int blend);
+
+void				SpriteBatchBegin(const SimBounds & view);
+void				SpriteBatchAdd(unsigned int sprite, float posX, float posY, float scale, float dir);
+void				SpriteBatchAddRect(unsigned int sprite, float minX, float minY, float maxX, float maxY, const AtlasRect & rect);
+void				SpriteBatchAddInstances(const GameObjInstHot & hot, unsigned long instNum, float alpha);
+SpriteBatchStats	SpriteBatchEnd(SpriteBatchFlushFn pfFlush);
+
+void				SpriteBatchSetTransformMode(unsigned int mode);
+unsigned int		SpriteBatchGetTransformMode(void);
+
+void				SpriteTransformBuildBatch(const float * pPosX, const float * pPosY, const float * pScale, const float * pDir,
+											  unsigned int num, SpriteTransform * pTransforms);
+
+void				SpriteBatchFlushNull(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum);
+
+// ---------------------------------------------------------------------------
+
+inline SpriteTransform SpriteTransformBuild(float posX, float posY, float scale, float dir)
+{
+	SpriteTransform transform;
+
+	transform.c		= cosf(dir) * scale;
+	transform.s		= sinf(dir) * scale;
+	transform.tx	= posX;
+	transform.ty	= posY;
+
+	return transform;
+}
+
+// ---------------------------------------------------------------------------
+
+#endif // CS230_SPRITE_BATCH_H_
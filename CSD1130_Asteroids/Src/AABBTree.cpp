@@ -0,0 +1,464 @@
+/* Start Header **************************************************************/
+/*!
+\file	AABBTree.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file implements the dynamic AABB tree holding the long-lived object
+instances.
+
+The nodes live in one array and freed nodes are chained into a free
+list, so a proxy is just a node index. Leaves are inserted next to the
+sibling that grows the tree's perimeter the least, and the tree is kept
+balanced with rotations on the way back up.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "AABBTree.h"
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct TreeNode
+{
+	AABB			box;		// fat box for a leaf, union of the children otherwise
+	unsigned int	id;			// id given to AABBTreeCreateProxy (leaves only)
+	int				parent;		// parent node, or next free node when not in use
+	int				child1;		// AABB_TREE_NULL for a leaf
+	int				child2;
+	int				height;		// 0 for a leaf, -1 when not in use
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static std::vector<TreeNode>	sTreeNodes;
+static int						sTreeRoot		= AABB_TREE_NULL;
+static int						sTreeFreeNode	= AABB_TREE_NULL;
+static unsigned int				sTreeProxyNum;		// number of leaves
+static std::vector<int>			sTreeStack;			// traversal stack of AABBTreeQuery
+
+/******************************************************************************/
+/*!
+	Box helpers
+*/
+/******************************************************************************/
+static AABB boxUnion(const AABB & a, const AABB & b)
+{
+	AABB box;
+	box.min.x = min(a.min.x, b.min.x);
+	box.min.y = min(a.min.y, b.min.y);
+	box.max.x = max(a.max.x, b.max.x);
+	box.max.y = max(a.max.y, b.max.y);
+	return box;
+}
+
+static float boxPerimeter(const AABB & box)
+{
+	return 2.0f * ((box.max.x - box.min.x) + (box.max.y - box.min.y));
+}
+
+static bool boxContains(const AABB & outer, const AABB & inner)
+{
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+		   inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+static bool boxOverlap(const AABB & a, const AABB & b)
+{
+	return !(a.min.x > b.max.x || b.min.x > a.max.x ||
+			 a.min.y > b.max.y || b.min.y > a.max.y);
+}
+
+/******************************************************************************/
+/*!
+	Fat box of a leaf: grown by the margin, then stretched along the
+	displacement so a steadily moving proxy is re-inserted less often
+*/
+/******************************************************************************/
+static AABB fatBox(const AABB & box, const AEVec2 & displacement)
+{
+	AABB fat = box;
+
+	fat.min.x -= AABB_TREE_MARGIN;
+	fat.min.y -= AABB_TREE_MARGIN;
+	fat.max.x += AABB_TREE_MARGIN;
+	fat.max.y += AABB_TREE_MARGIN;
+
+	float dx = AABB_TREE_DISPLACEMENT * displacement.x;
+	float dy = AABB_TREE_DISPLACEMENT * displacement.y;
+
+	if (dx < 0.0f)	fat.min.x += dx;
+	else			fat.max.x += dx;
+
+	if (dy < 0.0f)	fat.min.y += dy;
+	else			fat.max.y += dy;
+
+	return fat;
+}
+
+/******************************************************************************/
+/*!
+	Node allocation
+*/
+/******************************************************************************/
+static int nodeAllocate(void)
+{
+	int node;
+
+	if (sTreeFreeNode == AABB_TREE_NULL)
+	{
+		node = (int)sTreeNodes.size();
+		sTreeNodes.push_back(TreeNode());
+	}
+	else
+	{
+		node = sTreeFreeNode;
+		sTreeFreeNode = sTreeNodes[node].parent;
+	}
+
+	TreeNode & n = sTreeNodes[node];
+	n.id		= 0;
+	n.parent	= AABB_TREE_NULL;
+	n.child1	= AABB_TREE_NULL;
+	n.child2	= AABB_TREE_NULL;
+	n.height	= 0;
+
+	return node;
+}
+
+static void nodeFree(int node)
+{
+	sTreeNodes[node].parent	= sTreeFreeNode;
+	sTreeNodes[node].height	= -1;
+	sTreeFreeNode			= node;
+}
+
+/******************************************************************************/
+/*!
+	Refresh the box and height of an inner node from its children
+*/
+/******************************************************************************/
+static void nodeRefit(int node)
+{
+	TreeNode & n = sTreeNodes[node];
+	const TreeNode & c1 = sTreeNodes[n.child1];
+	const TreeNode & c2 = sTreeNodes[n.child2];
+
+	n.box		= boxUnion(c1.box, c2.box);
+	n.height	= 1 + max(c1.height, c2.height);
+}
+
+/******************************************************************************/
+/*!
+	Rotate the subtree at "a" if its children heights differ by more than
+	one. Returns the root of the subtree afterwards.
+*/
+/******************************************************************************/
+static int nodeBalance(int a)
+{
+	TreeNode & A = sTreeNodes[a];
+
+	if (A.child1 == AABB_TREE_NULL || A.height < 2)
+		return a;
+
+	int b = A.child1;
+	int c = A.child2;
+	int balance = sTreeNodes[c].height - sTreeNodes[b].height;
+
+	// "up" is the taller child, it takes the place of "a"
+	int up;
+	if (balance > 1)
+		up = c;
+	else if (balance < -1)
+		up = b;
+	else
+		return a;
+
+	TreeNode & U = sTreeNodes[up];
+	int f = U.child1;
+	int g = U.child2;
+
+	// swap "a" and "up"
+	U.child1	= a;
+	U.parent	= A.parent;
+	A.parent	= up;
+
+	if (U.parent != AABB_TREE_NULL)
+	{
+		TreeNode & P = sTreeNodes[U.parent];
+		if (P.child1 == a)	P.child1 = up;
+		else				P.child2 = up;
+	}
+	else
+		sTreeRoot = up;
+
+	// the taller grandchild stays under "up", the other one moves under "a"
+	int keep = f, move = g;
+	if (sTreeNodes[f].height < sTreeNodes[g].height)
+	{
+		keep = g;
+		move = f;
+	}
+
+	U.child2 = keep;
+	if (up == c)	A.child2 = move;
+	else			A.child1 = move;
+	sTreeNodes[move].parent = a;
+
+	nodeRefit(a);
+	nodeRefit(up);
+
+	return up;
+}
+
+/******************************************************************************/
+/*!
+	Insert a leaf next to the sibling that costs the least perimeter
+*/
+/******************************************************************************/
+static void leafInsert(int leaf)
+{
+	if (sTreeRoot == AABB_TREE_NULL)
+	{
+		sTreeRoot = leaf;
+		sTreeNodes[leaf].parent = AABB_TREE_NULL;
+		return;
+	}
+
+	AABB leafBox = sTreeNodes[leaf].box;
+	int index = sTreeRoot;
+
+	while (sTreeNodes[index].child1 != AABB_TREE_NULL)
+	{
+		const TreeNode & n = sTreeNodes[index];
+
+		float area			= boxPerimeter(n.box);
+		float combinedArea	= boxPerimeter(boxUnion(n.box, leafBox));
+
+		// cost of making a new parent for this node and the leaf
+		float cost			= 2.0f * combinedArea;
+
+		// minimum cost of pushing the leaf further down
+		float inheritance	= 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		int   children[2]	= { n.child1, n.child2 };
+
+		for (int k = 0; k < 2; k++)
+		{
+			const TreeNode & c = sTreeNodes[children[k]];
+			float grown = boxPerimeter(boxUnion(leafBox, c.box));
+
+			if (c.child1 == AABB_TREE_NULL)
+				childCost[k] = grown + inheritance;
+			else
+				childCost[k] = (grown - boxPerimeter(c.box)) + inheritance;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+
+		index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+	}
+
+	int sibling		= index;
+	int oldParent	= sTreeNodes[sibling].parent;
+	int newParent	= nodeAllocate();
+
+	TreeNode & np	= sTreeNodes[newParent];
+	np.parent		= oldParent;
+	np.child1		= sibling;
+	np.child2		= leaf;
+	np.box			= boxUnion(leafBox, sTreeNodes[sibling].box);
+	np.height		= sTreeNodes[sibling].height + 1;
+
+	sTreeNodes[sibling].parent	= newParent;
+	sTreeNodes[leaf].parent		= newParent;
+
+	if (oldParent != AABB_TREE_NULL)
+	{
+		TreeNode & op = sTreeNodes[oldParent];
+		if (op.child1 == sibling)	op.child1 = newParent;
+		else						op.child2 = newParent;
+	}
+	else
+		sTreeRoot = newParent;
+
+	// fix the boxes and heights on the way back up
+	index = sTreeNodes[leaf].parent;
+	while (index != AABB_TREE_NULL)
+	{
+		index = nodeBalance(index);
+		nodeRefit(index);
+		index = sTreeNodes[index].parent;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Unlink a leaf, its sibling takes the place of their parent
+*/
+/******************************************************************************/
+static void leafRemove(int leaf)
+{
+	if (leaf == sTreeRoot)
+	{
+		sTreeRoot = AABB_TREE_NULL;
+		return;
+	}
+
+	int parent		= sTreeNodes[leaf].parent;
+	int grandParent	= sTreeNodes[parent].parent;
+	int sibling		= (sTreeNodes[parent].child1 == leaf) ? sTreeNodes[parent].child2 : sTreeNodes[parent].child1;
+
+	if (grandParent != AABB_TREE_NULL)
+	{
+		TreeNode & gp = sTreeNodes[grandParent];
+		if (gp.child1 == parent)	gp.child1 = sibling;
+		else						gp.child2 = sibling;
+
+		sTreeNodes[sibling].parent = grandParent;
+		nodeFree(parent);
+
+		int index = grandParent;
+		while (index != AABB_TREE_NULL)
+		{
+			index = nodeBalance(index);
+			nodeRefit(index);
+			index = sTreeNodes[index].parent;
+		}
+	}
+	else
+	{
+		sTreeRoot = sibling;
+		sTreeNodes[sibling].parent = AABB_TREE_NULL;
+		nodeFree(parent);
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int AABBTreeCreateProxy(const AABB & box, unsigned int id)
+{
+	AEVec2 still = { 0.0f, 0.0f };
+	int leaf = nodeAllocate();
+
+	sTreeNodes[leaf].box	= fatBox(box, still);
+	sTreeNodes[leaf].id		= id;
+
+	leafInsert(leaf);
+	sTreeProxyNum++;
+
+	return leaf;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void AABBTreeDestroyProxy(int proxy)
+{
+	AE_ASSERT_PARM(proxy >= 0 && proxy < (int)sTreeNodes.size() && sTreeNodes[proxy].height == 0);
+
+	leafRemove(proxy);
+	nodeFree(proxy);
+	sTreeProxyNum--;
+}
+
+/******************************************************************************/
+/*!
+	Nothing to do while the box stays inside the fat box of the leaf
+*/
+/******************************************************************************/
+bool AABBTreeMoveProxy(int proxy, const AABB & box, const AEVec2 & displacement)
+{
+	AE_ASSERT_PARM(proxy >= 0 && proxy < (int)sTreeNodes.size() && sTreeNodes[proxy].height == 0);
+
+	if (boxContains(sTreeNodes[proxy].box, box))
+		return false;
+
+	leafRemove(proxy);
+	sTreeNodes[proxy].box = fatBox(box, displacement);
+	leafInsert(proxy);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int AABBTreeQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax)
+{
+	unsigned int resultNum = 0;
+
+	if (sTreeRoot == AABB_TREE_NULL)
+		return 0;
+
+	sTreeStack.clear();
+	sTreeStack.push_back(sTreeRoot);
+
+	while (!sTreeStack.empty())
+	{
+		int index = sTreeStack.back();
+		sTreeStack.pop_back();
+
+		const TreeNode & n = sTreeNodes[index];
+
+		if (!boxOverlap(n.box, box))
+			continue;
+
+		if (n.child1 == AABB_TREE_NULL)
+		{
+			if (resultNum < resultMax)
+				pResult[resultNum++] = n.id;
+		}
+		else
+		{
+			sTreeStack.push_back(n.child1);
+			sTreeStack.push_back(n.child2);
+		}
+	}
+
+	return resultNum;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int AABBTreeProxyNum(void)
+{
+	return sTreeProxyNum;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void AABBTreeClear(void)
+{
+	sTreeNodes.clear();
+	sTreeRoot		= AABB_TREE_NULL;
+	sTreeFreeNode	= AABB_TREE_NULL;
+	sTreeProxyNum	= 0;
+}
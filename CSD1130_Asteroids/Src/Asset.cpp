@@ -0,0 +1,266 @@
+/* Start Header **************************************************************/
+/*!
+\file	Asset.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file keeps the textures of the game states by file name. A texture
+is looked for by its name when acquired and by its pointer when
+released; there are few enough for a walk through all of them.
+The images in the asset pack (see Pack.h) are uploaded from it as they
+are, the others are decoded from their PNG.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Asset.h"
+#include "Image.h"
+#include "Pack.h"
+#include "Profile.h"
+#include <string>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	ASSET_SLOT_NONE			= IMAGE_LOADER_SLOT_MAX;	// not being decoded
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct AssetTexture
+{
+	std::string			fileName;
+	AEGfxTexture *		pTexture;		// 0 until acquired
+	unsigned int		refNum;			// game states holding it
+	unsigned int		slot;			// loader slot decoding the image, or ASSET_SLOT_NONE
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static AssetTexture		sAssetTextures[ASSET_TEXTURE_MAX];
+static unsigned int		sAssetTextureNum;
+
+/******************************************************************************/
+/*!
+	Index of the texture of "pFileName", or sAssetTextureNum if there is none
+*/
+/******************************************************************************/
+static unsigned int assetTextureFind(const char * pFileName)
+{
+	unsigned int i = 0;
+
+	while (i < sAssetTextureNum && sAssetTextures[i].fileName != pFileName)
+		i++;
+
+	return i;
+}
+
+/******************************************************************************/
+/*!
+	First loader slot no texture is decoded in, or ASSET_SLOT_NONE if
+	they are all busy
+*/
+/******************************************************************************/
+static unsigned int assetSlotFind(void)
+{
+	for (unsigned int slot = 0; slot < IMAGE_LOADER_SLOT_MAX; slot++)
+	{
+		unsigned int i = 0;
+
+		while (i < sAssetTextureNum && sAssetTextures[i].slot != slot)
+			i++;
+
+		if (i == sAssetTextureNum)
+			return slot;
+	}
+
+	return ASSET_SLOT_NONE;
+}
+
+/******************************************************************************/
+/*!
+	Frees the decoded pixels once no slot has any waiting to be a texture
+*/
+/******************************************************************************/
+static void assetSlotsFree(void)
+{
+	for (unsigned int i = 0; i < sAssetTextureNum; i++)
+		if (sAssetTextures[i].slot != ASSET_SLOT_NONE)
+			return;
+
+	ImageLoaderFree();
+}
+
+/******************************************************************************/
+/*!
+	Removes the texture at "index", moving the last one in its place
+*/
+/******************************************************************************/
+static void assetTextureRemove(unsigned int index)
+{
+	sAssetTextureNum--;
+
+	if (index != sAssetTextureNum)
+		sAssetTextures[index] = sAssetTextures[sAssetTextureNum];
+
+	sAssetTextures[sAssetTextureNum].fileName.clear();
+}
+
+/******************************************************************************/
+/*!
+	Makes a texture of the image, from the pack if it is in it, else
+	from its slot if it was prefetched
+*/
+/******************************************************************************/
+static AEGfxTexture * assetTextureLoad(AssetTexture & asset)
+{
+	// the engine only reads the pixels it is given
+	PackImage packed;
+	if (PackFind(asset.fileName.c_str(), packed))
+		return AEGfxTextureLoadFromMemory((u8 *)packed.pPixels, packed.width, packed.height);
+
+	Image	image;
+	Image *	pImage;
+
+	if (asset.slot != ASSET_SLOT_NONE)
+		pImage = ImageLoaderWait(asset.slot);
+	else
+		pImage = ImageLoadPng(asset.fileName.c_str(), image) ? &image : nullptr;
+
+	// the engine's textures belong to the main thread
+	AEGfxTexture * pTexture = nullptr;
+	if (pImage)
+		pTexture = AEGfxTextureLoadFromMemory(&pImage->pixels[0], pImage->width, pImage->height);
+
+	asset.slot = ASSET_SLOT_NONE;
+	assetSlotsFree();
+
+	return pTexture;
+}
+
+/******************************************************************************/
+/*!
+	The image is decoded on a free loader slot; with none free, it is
+	decoded when acquired. The pack's images need no decoding
+*/
+/******************************************************************************/
+void AssetTexturePrefetch(const char * pFileName)
+{
+	AE_ASSERT_PARM(pFileName);
+
+	PackImage packed;
+	if (assetTextureFind(pFileName) < sAssetTextureNum || PackFind(pFileName, packed))
+		return;
+
+	AE_ASSERT_MESG(sAssetTextureNum < ASSET_TEXTURE_MAX, "Too many textures!!");
+
+	unsigned int slot = assetSlotFind();
+	if (slot == ASSET_SLOT_NONE)
+		return;
+
+	AssetTexture & asset = sAssetTextures[sAssetTextureNum++];
+	asset.fileName	= pFileName;
+	asset.pTexture	= nullptr;
+	asset.refNum	= 0;
+	asset.slot		= slot;
+
+	ImageLoaderStart(slot, pFileName);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+AEGfxTexture * AssetTextureAcquire(const char * pFileName)
+{
+	AE_ASSERT_PARM(pFileName);
+	PROFILE_ZONE("AssetTextureAcquire");
+
+	unsigned int index = assetTextureFind(pFileName);
+
+	if (index == sAssetTextureNum)
+	{
+		AE_ASSERT_MESG(sAssetTextureNum < ASSET_TEXTURE_MAX, "Too many textures!!");
+
+		AssetTexture & asset = sAssetTextures[sAssetTextureNum++];
+		asset.fileName	= pFileName;
+		asset.pTexture	= nullptr;
+		asset.refNum	= 0;
+		asset.slot		= ASSET_SLOT_NONE;
+	}
+
+	AssetTexture & asset = sAssetTextures[index];
+
+	if (!asset.pTexture)
+	{
+		asset.pTexture = assetTextureLoad(asset);
+
+		if (!asset.pTexture)
+		{
+			assetTextureRemove(index);
+			return nullptr;
+		}
+	}
+
+	asset.refNum++;
+
+	return asset.pTexture;
+}
+
+/******************************************************************************/
+/*!
+	The texture stays loaded until the next AssetCollect
+*/
+/******************************************************************************/
+void AssetTextureRelease(AEGfxTexture * pTexture)
+{
+	unsigned int i = 0;
+
+	while (i < sAssetTextureNum && sAssetTextures[i].pTexture != pTexture)
+		i++;
+
+	AE_ASSERT_MESG(pTexture && i < sAssetTextureNum && sAssetTextures[i].refNum > 0,
+				   "Releasing a texture that is not held!!");
+
+	sAssetTextures[i].refNum--;
+}
+
+/******************************************************************************/
+/*!
+	Also drops the images prefetched and never acquired
+*/
+/******************************************************************************/
+void AssetCollect(void)
+{
+	// backwards, the removal moves the last texture in place of the current one
+	for (unsigned int i = sAssetTextureNum; i-- > 0; )
+	{
+		AssetTexture & asset = sAssetTextures[i];
+
+		if (asset.refNum > 0)
+			continue;
+
+		if (asset.slot != ASSET_SLOT_NONE)
+			ImageLoaderWait(asset.slot);
+
+		if (asset.pTexture)
+			AEGfxTextureUnload(asset.pTexture);
+
+		assetTextureRemove(i);
+	}
+
+	assetSlotsFree();
+}
@@ -0,0 +1,153 @@
+/* Start Header **************************************************************/
+/*!
+\file	Atlas.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file reads the texture atlas description written by
+Tools/AtlasPack.py:
+
+	atlas <image> <width> <height>
+	<sprite> <x> <y> <width> <height>
+	...
+
+in pixels from the top left of the image. Lines starting with '#' are
+comments. The pixel rectangles are turned into texture coordinates once,
+when the description is read.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Atlas.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct AtlasSprite
+{
+	std::string			name;
+	AtlasRect			rect;
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static std::string					sAtlasImage;		// path of the packed image
+static std::vector<AtlasSprite>		sAtlasSprites;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool AtlasLoad(const char * pFileName)
+{
+	AtlasUnload();
+
+	std::ifstream file(pFileName);
+	if (!file)
+		return false;
+
+	// the image sits next to its description
+	std::string dir(pFileName);
+	size_t slash = dir.find_last_of("/\\");
+	dir = (slash == std::string::npos) ? std::string() : dir.substr(0, slash + 1);
+
+	float width = 0.0f, height = 0.0f;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string name;
+		fields >> name;
+
+		if (name == "atlas")
+		{
+			std::string image;
+			fields >> image >> width >> height;
+			sAtlasImage = dir + image;
+		}
+		else
+		{
+			float x, y, w, h;
+			fields >> x >> y >> w >> h;
+
+			// the sprites come after the atlas size
+			if (width <= 0.0f || height <= 0.0f)
+				fields.setstate(std::ios::failbit);
+
+			AtlasSprite sprite;
+			sprite.name		= name;
+			sprite.rect.u0	= x / width;
+			sprite.rect.v0	= y / height;
+			sprite.rect.u1	= (x + w) / width;
+			sprite.rect.v1	= (y + h) / height;
+			sAtlasSprites.push_back(sprite);
+		}
+
+		if (fields.fail())
+		{
+			AtlasUnload();
+			return false;
+		}
+	}
+
+	return !sAtlasImage.empty();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+const char * AtlasGetImage(void)
+{
+	return sAtlasImage.c_str();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool AtlasFind(const char * pName, AtlasRect & rect)
+{
+	for (size_t i = 0; i < sAtlasSprites.size(); i++)
+	{
+		if (sAtlasSprites[i].name == pName)
+		{
+			rect = sAtlasSprites[i].rect;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void AtlasUnload(void)
+{
+	sAtlasImage.clear();
+	sAtlasSprites.clear();
+}
@@ -0,0 +1,462 @@
+/* Start Header **************************************************************/
+/*!
+\file	Broadphase.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file implements the broadphase used to find the pairs of object
+instances that are worth a CollisionIntersection_RectRect call.
+
+The grid is a spatial hash: a cell (x, y) is hashed into one of a
+power-of-two number of buckets, so objects wrapped outside the window
+need no special case. Hash collisions only add candidates, the narrow
+phase rejects them.
+
+The sort and sweep list is kept from one frame to the next. Objects move
+little between frames, so the insertion sort that restores the order
+along X only does a few swaps.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Broadphase.h"
+#include "AABBTree.h"
+#include <vector>
+#include <algorithm>
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+
+// uniform grid, rebuilt by BroadphaseGridBuild
+static float						sGridCellSize;		// width and height of a cell
+static unsigned int					sGridBucketMask;	// number of buckets - 1
+static std::vector<unsigned int>	sGridBucketStart;	// first entry of each bucket, one extra at the end
+static std::vector<unsigned int>	sGridEntries;		// ids of the boxes, grouped by bucket
+static std::vector<unsigned int>	sGridCursor;		// write cursor of each bucket while building
+
+// per id query stamp, so an id spanning several cells is reported once
+static std::vector<unsigned int>	sGridStamp;
+static unsigned int					sGridQueryNum;
+static std::vector<unsigned int>	sQueryResult;		// ids returned by one grid or tree query
+static std::vector<AABB>			sGridBoxes;			// target boxes gathered by BroadphaseFindPairs
+static std::vector<unsigned int>	sGridIds;			// ids of the target boxes
+
+// sort and sweep list, sorted by box.min.x and kept between frames
+struct SweepEntry
+{
+	AABB				box;
+	unsigned int		id;
+	unsigned char		group;
+};
+
+static std::vector<SweepEntry>		sSweepList;
+static std::vector<unsigned int>	sSweepInput;		// per id, 1 + index in this frame's input, 0 if not there
+
+// candidate pairs handed back to the caller
+static std::vector<BroadphasePair>	sPairs;
+
+/******************************************************************************/
+/*!
+	Order of the pairs handed back by every mode
+*/
+/******************************************************************************/
+static bool pairLess(const BroadphasePair & a, const BroadphasePair & b)
+{
+	if (a.queryId != b.queryId)
+		return a.queryId < b.queryId;
+	return a.targetId < b.targetId;
+}
+
+/******************************************************************************/
+/*!
+	Hash of the cell (x, y) into a bucket index
+*/
+/******************************************************************************/
+static unsigned int gridHash(int x, int y)
+{
+	return ((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u) & sGridBucketMask;
+}
+
+/******************************************************************************/
+/*!
+	Range of cells covered by a box
+*/
+/******************************************************************************/
+static void gridCellRange(const AABB & box, int & x0, int & y0, int & x1, int & y1)
+{
+	x0 = (int)floorf(box.min.x / sGridCellSize);
+	y0 = (int)floorf(box.min.y / sGridCellSize);
+	x1 = (int)floorf(box.max.x / sGridCellSize);
+	y1 = (int)floorf(box.max.y / sGridCellSize);
+}
+
+/******************************************************************************/
+/*!
+	
+*/
+/******************************************************************************/
+const char * BroadphaseModeName(unsigned int mode)
+{
+	switch (mode)
+	{
+	case BROADPHASE_BRUTE_FORCE:	return "brute force";
+	case BROADPHASE_GRID:			return "grid";
+	case BROADPHASE_SWEEP:			return "sort and sweep";
+	case BROADPHASE_TREE:			return "AABB tree";
+	default:						return "unknown";
+	}
+}
+
+/******************************************************************************/
+/*!
+	Candidate pairs between the query and the target boxes, using the
+	given broadphase mode
+*/
+/******************************************************************************/
+const BroadphasePair * BroadphaseFindPairs(unsigned int mode, const AABB * pBoxes, const unsigned int * pIds,
+										   const unsigned char * pGroups, unsigned int count, unsigned int & pairNum)
+{
+	sPairs.clear();
+
+	switch (mode)
+	{
+	case BROADPHASE_BRUTE_FORCE:
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (pGroups[i] != BROADPHASE_GROUP_QUERY)
+				continue;
+
+			for (unsigned int j = 0; j < count; j++)
+			{
+				if (pGroups[j] != BROADPHASE_GROUP_TARGET)
+					continue;
+
+				BroadphasePair pair = { pIds[i], pIds[j] };
+				sPairs.push_back(pair);
+			}
+		}
+		break;
+
+	case BROADPHASE_GRID:
+	{
+		// gather the targets, they are what the grid holds
+		std::vector<AABB> &			boxes	= sGridBoxes;
+		std::vector<unsigned int> &	ids		= sGridIds;
+		float						extent	= 0.0f;
+
+		boxes.clear();
+		ids.clear();
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (pGroups[i] != BROADPHASE_GROUP_TARGET)
+				continue;
+
+			boxes.push_back(pBoxes[i]);
+			ids.push_back(pIds[i]);
+			extent += max(pBoxes[i].max.x - pBoxes[i].min.x, pBoxes[i].max.y - pBoxes[i].min.y);
+		}
+
+		if (boxes.empty())
+			break;
+
+		// cells twice the average target size, so a target spans at most 2x2 cells
+		BroadphaseGridBuild(boxes.data(), ids.data(), (unsigned int)boxes.size(),
+							max(2.0f * extent / boxes.size(), 1.0f));
+
+		sQueryResult.resize(boxes.size());
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (pGroups[i] != BROADPHASE_GROUP_QUERY)
+				continue;
+
+			unsigned int resultNum = BroadphaseGridQuery(pBoxes[i], sQueryResult.data(), (unsigned int)sQueryResult.size());
+
+			for (unsigned int r = 0; r < resultNum; r++)
+			{
+				BroadphasePair pair = { pIds[i], sQueryResult[r] };
+				sPairs.push_back(pair);
+			}
+		}
+		break;
+	}
+
+	case BROADPHASE_TREE:
+	{
+		if (AABBTreeProxyNum() == 0)
+			break;
+
+		sQueryResult.resize(AABBTreeProxyNum());
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (pGroups[i] != BROADPHASE_GROUP_QUERY)
+				continue;
+
+			unsigned int resultNum = AABBTreeQuery(pBoxes[i], sQueryResult.data(), (unsigned int)sQueryResult.size());
+
+			for (unsigned int r = 0; r < resultNum; r++)
+			{
+				BroadphasePair pair = { pIds[i], sQueryResult[r] };
+				sPairs.push_back(pair);
+			}
+		}
+		break;
+	}
+
+	case BROADPHASE_SWEEP:
+	{
+		BroadphaseSweepUpdate(pBoxes, pIds, pGroups, count);
+		BroadphaseSweepPairs(pairNum);
+		break;
+	}
+
+	default:
+		AE_FATAL_ERROR("invalid broadphase mode!!");
+	}
+
+	std::sort(sPairs.begin(), sPairs.end(), pairLess);
+
+	pairNum = (unsigned int)sPairs.size();
+	return sPairs.data();
+}
+
+/******************************************************************************/
+/*!
+	Box covering "box" over the whole [0, dt] time interval
+*/
+/******************************************************************************/
+AABB BroadphaseSweptBox(const AABB & box, const AEVec2 & vel, float dt)
+{
+	AABB swept = box;
+
+	float dx = vel.x * dt;
+	float dy = vel.y * dt;
+
+	if (dx < 0.0f)	swept.min.x += dx;
+	else			swept.max.x += dx;
+
+	if (dy < 0.0f)	swept.min.y += dy;
+	else			swept.max.y += dy;
+
+	return swept;
+}
+
+/******************************************************************************/
+/*!
+	Bucket the boxes by the cells they overlap, using a counting sort so
+	the whole grid sits in two flat arrays
+*/
+/******************************************************************************/
+void BroadphaseGridBuild(const AABB * pBoxes, const unsigned int * pIds,
+						 unsigned int count, float cellSize)
+{
+	AE_ASSERT_PARM(cellSize > 0.0f);
+
+	sGridCellSize = cellSize;
+
+	// about two buckets per box keeps the collisions low
+	unsigned int bucketNum = 64;
+	while (bucketNum < count * 2)
+		bucketNum <<= 1;
+	sGridBucketMask = bucketNum - 1;
+
+	sGridBucketStart.assign(bucketNum + 1, 0);
+
+	unsigned int idMax = 0;
+
+	// count the entries of every bucket
+	for (unsigned int i = 0; i < count; i++)
+	{
+		int x0, y0, x1, y1;
+		gridCellRange(pBoxes[i], x0, y0, x1, y1);
+
+		for (int y = y0; y <= y1; y++)
+			for (int x = x0; x <= x1; x++)
+				sGridBucketStart[gridHash(x, y) + 1]++;
+
+		if (pIds[i] > idMax)
+			idMax = pIds[i];
+	}
+
+	// turn the counts into start offsets
+	for (unsigned int b = 0; b < bucketNum; b++)
+		sGridBucketStart[b + 1] += sGridBucketStart[b];
+
+	// drop the ids in, using a copy of the offsets as write cursors
+	sGridCursor.assign(sGridBucketStart.begin(), sGridBucketStart.end() - 1);
+	sGridEntries.resize(sGridBucketStart[bucketNum]);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		int x0, y0, x1, y1;
+		gridCellRange(pBoxes[i], x0, y0, x1, y1);
+
+		for (int y = y0; y <= y1; y++)
+			for (int x = x0; x <= x1; x++)
+				sGridEntries[sGridCursor[gridHash(x, y)]++] = pIds[i];
+	}
+
+	if (count && sGridStamp.size() <= idMax)
+		sGridStamp.resize(idMax + 1, 0);
+}
+
+/******************************************************************************/
+/*!
+	Collect the ids stored in every cell overlapped by "box"
+*/
+/******************************************************************************/
+unsigned int BroadphaseGridQuery(const AABB & box, unsigned int * pResult, unsigned int resultMax)
+{
+	if (sGridBucketStart.empty())
+		return 0;
+
+	// new stamp for this query, clear them all on wrap around
+	if (++sGridQueryNum == 0)
+	{
+		sGridStamp.assign(sGridStamp.size(), 0);
+		sGridQueryNum = 1;
+	}
+
+	unsigned int resultNum = 0;
+
+	int x0, y0, x1, y1;
+	gridCellRange(box, x0, y0, x1, y1);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			unsigned int b = gridHash(x, y);
+
+			for (unsigned int e = sGridBucketStart[b]; e < sGridBucketStart[b + 1]; e++)
+			{
+				unsigned int id = sGridEntries[e];
+
+				if (sGridStamp[id] == sGridQueryNum)
+					continue;
+				sGridStamp[id] = sGridQueryNum;
+
+				if (resultNum < resultMax)
+					pResult[resultNum++] = id;
+			}
+		}
+	}
+
+	return resultNum;
+}
+
+/******************************************************************************/
+/*!
+	Bring the sort and sweep list up to date with this frame's boxes:
+	drop the ids that are gone, refresh the boxes of the others in place,
+	append the new ids, then restore the order along X
+*/
+/******************************************************************************/
+void BroadphaseSweepUpdate(const AABB * pBoxes, const unsigned int * pIds,
+						   const unsigned char * pGroups, unsigned int count)
+{
+	// map this frame's ids to their input index
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (sSweepInput.size() <= pIds[i])
+			sSweepInput.resize(pIds[i] + 1, 0);
+		sSweepInput[pIds[i]] = i + 1;
+	}
+
+	// keep the entries still there, in the order of last frame
+	unsigned int keepNum = 0;
+
+	for (unsigned int e = 0; e < sSweepList.size(); e++)
+	{
+		SweepEntry entry = sSweepList[e];
+
+		if (entry.id >= sSweepInput.size() || sSweepInput[entry.id] == 0)
+			continue;
+
+		unsigned int i = sSweepInput[entry.id] - 1;
+		entry.box	= pBoxes[i];
+		entry.group	= pGroups[i];
+
+		// consumed, so the append loop below skips it
+		sSweepInput[entry.id] = 0;
+
+		sSweepList[keepNum++] = entry;
+	}
+
+	sSweepList.resize(keepNum);
+
+	// append the ids that were not in the list
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (sSweepInput[pIds[i]] == 0)
+			continue;
+
+		SweepEntry entry = { pBoxes[i], pIds[i], pGroups[i] };
+		sSweepList.push_back(entry);
+
+		sSweepInput[pIds[i]] = 0;
+	}
+
+	// insertion sort, close to linear as the list is almost sorted
+	for (unsigned int e = 1; e < sSweepList.size(); e++)
+	{
+		SweepEntry entry = sSweepList[e];
+		unsigned int k = e;
+
+		while (k > 0 && sSweepList[k - 1].box.min.x > entry.box.min.x)
+		{
+			sSweepList[k] = sSweepList[k - 1];
+			k--;
+		}
+
+		sSweepList[k] = entry;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Sweep the sorted list along X: each entry only meets the entries that
+	start before it ends
+*/
+/******************************************************************************/
+const BroadphasePair * BroadphaseSweepPairs(unsigned int & pairNum)
+{
+	sPairs.clear();
+
+	unsigned int entryNum = (unsigned int)sSweepList.size();
+
+	for (unsigned int i = 0; i < entryNum; i++)
+	{
+		const SweepEntry & a = sSweepList[i];
+
+		for (unsigned int j = i + 1; j < entryNum && sSweepList[j].box.min.x <= a.box.max.x; j++)
+		{
+			const SweepEntry & b = sSweepList[j];
+
+			if (a.group == b.group)
+				continue;
+
+			// X overlaps by construction, check Y
+			if (a.box.min.y > b.box.max.y || b.box.min.y > a.box.max.y)
+				continue;
+
+			BroadphasePair pair;
+			pair.queryId	= (a.group == BROADPHASE_GROUP_QUERY) ? a.id : b.id;
+			pair.targetId	= (a.group == BROADPHASE_GROUP_QUERY) ? b.id : a.id;
+			sPairs.push_back(pair);
+		}
+	}
+
+	pairNum = (unsigned int)sPairs.size();
+	return sPairs.data();
+}
@@ -12,6 +12,14 @@ The functions include:
 	\n The first argument “aabb1” of type “AABB” holds the information of the bounding box of the first object instance.
 	\n The return type bool should return 0 for “No Intersection” and 1 for “Intersection”.
 
+\li \c bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, const AABB & aabb2, const AEVec2 & vel2, float dt, float & tFirst);
+	\n Same test over the [0, dt] interval, "tFirst" gets the time of the first contact.
+
+\li \c unsigned int CollisionIntersection_RectRectBatch(const AABB & aabb1, const AEVec2 & vel1, const AABBBatch & batch, float dt, unsigned int * pHitMask, float * pTFirst);
+	\n Tests "aabb1" against every box of the batch, 4 or 8 boxes at a time with SSE/AVX2.
+	\n Bit i of pHitMask (one word per 32 boxes) is set when box i is hit, pTFirst[i] then
+	\n holds its time of first contact. Returns the number of boxes hit.
+
 Copyright (C) 20xx DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
 without the prior written consent of DigiPen Institute of
@@ -19,105 +27,262 @@ Technology is prohibited.
 */
 /* End Header ****************************************************************/
 
-#include "main.h"
+#include "Collision.h"
+#include <cfloat>
+
+// widest vector unit the build targets, the batch test falls back to the
+// scalar test for the boxes left over
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define COLLISION_BATCH_WIDTH 8
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define COLLISION_BATCH_WIDTH 4
+#else
+	#define COLLISION_BATCH_WIDTH 1
+#endif
 
 /**************************************************************************/
 /*!
+	One axis of the swept test: box b moves at "vel" relative to box a.
+	Narrows [tFirst, tLast] to the times the boxes overlap on this axis
+	and returns false once the interval is empty.
+	*/
+/**************************************************************************/
+static bool sweepAxis(float a_min, float a_max, float b_min, float b_max, float vel,
+					  float & tFirst, float & tLast)
+{
+	// not moving along this axis, the boxes overlap all the time or never
+	if (vel == 0.0f)
+		return !(a_min > b_max || a_max < b_min) && tFirst <= tLast;
 
+	// times at which b's max side reaches a's min side and b's min side leaves a's max side
+	float t1 = (a_min - b_max) / vel;
+	float t2 = (a_max - b_min) / vel;
+
+	tFirst	= max(tFirst, min(t1, t2));
+	tLast	= min(tLast, max(t1, t2));
+
+	return tFirst <= tLast;
+}
+
+#if CS230_ALPHA_ENGINE
+/**************************************************************************/
+/*!
+	Over the current frame time, only with the engine
 	*/
 /**************************************************************************/
 bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, 
 									const AABB & aabb2, const AEVec2 & vel2)
 {
-	UNREFERENCED_PARAMETER(aabb1);
-	UNREFERENCED_PARAMETER(vel1);
-	UNREFERENCED_PARAMETER(aabb2);
-	UNREFERENCED_PARAMETER(vel2);
-	float a_min_x = aabb1.min.x;
-	float a_max_x = aabb1.max.x;
-	float b_min_x = aabb2.min.x;
-	float b_max_x = aabb2.max.x;
-	float a_min_y = aabb1.min.y;
-	float a_max_y = aabb1.max.y;
-	float b_min_y = aabb2.min.y;
-	float b_max_y = aabb2.max.y;
-
-	// step 1
-	if (!(a_min_x > b_max_x || a_max_x < b_min_x ||
-		a_min_y < b_max_y || a_max_y > b_min_y)) {
-		return 1;
-	}
-	// x-axis test
-	// step 2
-	AEVec2 relative_vel;
-	AEVec2 unconst_vel1 = vel1;
-	AEVec2 unconst_vel2 = vel2;
-	AEVec2Sub(&relative_vel, &unconst_vel2, &unconst_vel1);
-	float t_first = 0;
-	float t_last = (float)AEFrameRateControllerGetFrameTime();
-	// step 3
-	if (relative_vel.x < 0) {
-		// case 1
-		if (a_min_x > b_max_x) {
-			return 0;
-		}
-		// case 4 - revisited
-		if (a_max_x < b_min_x) {
-			t_first = max((a_max_x - b_min_x) / relative_vel.x, t_first);
-		}
-		if (a_min_x < b_max_x) {
-			t_last = min((a_min_x - b_max_x) / relative_vel.x, t_last);
-		}
-	}
-	else {
-		// case 2 - revisited
-		if (a_min_x > b_max_x) {
-			t_first = max((a_min_x - b_max_x) / relative_vel.x, t_first);
-		}
-		if (a_max_x > b_min_x) {
-			t_last = min((a_max_x - b_min_x) / relative_vel.x, t_last);
-		}
-		// case 3
-		if (a_max_x < b_min_x) {
-			return 0;
-		}
-	}
-	// case 5
-	if (t_first > t_last) {
+	float tFirst;
+
+	return CollisionIntersection_RectRect(aabb1, vel1, aabb2, vel2,
+										  (float)AEFrameRateControllerGetFrameTime(), tFirst);
+}
+#endif
+
+/**************************************************************************/
+/*!
+	Boxes already overlapping hit at time 0, otherwise the hit is at the
+	latest of the axis entry times as long as it comes before the earliest
+	exit time and before dt
+	*/
+/**************************************************************************/
+bool CollisionIntersection_RectRect(const AABB & aabb1, const AEVec2 & vel1, 
+									const AABB & aabb2, const AEVec2 & vel2,
+									float dt, float & tFirst)
+{
+	// velocity of the second box relative to the first one
+	float rel_vel_x = vel2.x - vel1.x;
+	float rel_vel_y = vel2.y - vel1.y;
+
+	float t_first	= 0.0f;
+	float t_last	= dt;
+
+	if (!sweepAxis(aabb1.min.x, aabb1.max.x, aabb2.min.x, aabb2.max.x, rel_vel_x, t_first, t_last))
+		return 0;
+
+	if (!sweepAxis(aabb1.min.y, aabb1.max.y, aabb2.min.y, aabb2.max.y, rel_vel_y, t_first, t_last))
 		return 0;
+
+	tFirst = t_first;
+	return 1;
+}
+
+#if COLLISION_BATCH_WIDTH == 8
+/**************************************************************************/
+/*!
+	AVX2 version of "sweepAxis" over 8 boxes. Same operations in the same
+	order so the results match the scalar test bit for bit.
+	*/
+/**************************************************************************/
+static inline void sweepAxis8(__m256 a_min, __m256 a_max, __m256 b_min, __m256 b_max, __m256 vel,
+							  __m256 & tFirst, __m256 & tLast)
+{
+	__m256 zero		= _mm256_setzero_ps();
+	__m256 big		= _mm256_set1_ps(FLT_MAX);
+
+	__m256 t1		= _mm256_div_ps(_mm256_sub_ps(a_min, b_max), vel);
+	__m256 t2		= _mm256_div_ps(_mm256_sub_ps(a_max, b_min), vel);
+	__m256 enter	= _mm256_min_ps(t1, t2);
+	__m256 exit		= _mm256_max_ps(t1, t2);
+
+	// lanes not moving along this axis: always in or never in
+	__m256 still	= _mm256_cmp_ps(vel, zero, _CMP_EQ_OQ);
+	__m256 overlap	= _mm256_and_ps(_mm256_cmp_ps(a_min, b_max, _CMP_LE_OQ), _mm256_cmp_ps(b_min, a_max, _CMP_LE_OQ));
+	__m256 enterStill = _mm256_blendv_ps(big, _mm256_sub_ps(zero, big), overlap);
+
+	enter	= _mm256_blendv_ps(enter, enterStill, still);
+	exit	= _mm256_blendv_ps(exit, big, still);
+
+	tFirst	= _mm256_max_ps(tFirst, enter);
+	tLast	= _mm256_min_ps(tLast, exit);
+}
+#elif COLLISION_BATCH_WIDTH == 4
+/**************************************************************************/
+/*!
+	SSE2 version of "sweepAxis" over 4 boxes. Same operations in the same
+	order so the results match the scalar test bit for bit.
+	*/
+/**************************************************************************/
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline void sweepAxis4(__m128 a_min, __m128 a_max, __m128 b_min, __m128 b_max, __m128 vel,
+							  __m128 & tFirst, __m128 & tLast)
+{
+	__m128 zero		= _mm_setzero_ps();
+	__m128 big		= _mm_set1_ps(FLT_MAX);
+
+	__m128 t1		= _mm_div_ps(_mm_sub_ps(a_min, b_max), vel);
+	__m128 t2		= _mm_div_ps(_mm_sub_ps(a_max, b_min), vel);
+	__m128 enter	= _mm_min_ps(t1, t2);
+	__m128 exit		= _mm_max_ps(t1, t2);
+
+	// lanes not moving along this axis: always in or never in
+	__m128 still	= _mm_cmpeq_ps(vel, zero);
+	__m128 overlap	= _mm_and_ps(_mm_cmple_ps(a_min, b_max), _mm_cmple_ps(b_min, a_max));
+	__m128 enterStill = select4(overlap, _mm_sub_ps(zero, big), big);
+
+	enter	= select4(still, enterStill, enter);
+	exit	= select4(still, big, exit);
+
+	tFirst	= _mm_max_ps(tFirst, enter);
+	tLast	= _mm_min_ps(tLast, exit);
+}
+#endif
+
+/**************************************************************************/
+/*!
+	Batch version of the swept test: "aabb1" against every box of "batch"
+	*/
+/**************************************************************************/
+unsigned int CollisionIntersection_RectRectBatch(const AABB & aabb1, const AEVec2 & vel1,
+												 const AABBBatch & batch, float dt,
+												 unsigned int * pHitMask, float * pTFirst)
+{
+	AE_ASSERT_PARM(pHitMask && pTFirst);
+
+	unsigned int i		= 0;
+	unsigned int hitNum	= 0;
+
+	for (unsigned int w = 0; w < (batch.count + 31) / 32; w++)
+		pHitMask[w] = 0;
+
+#if COLLISION_BATCH_WIDTH == 8
+	__m256 aMinX = _mm256_set1_ps(aabb1.min.x), aMaxX = _mm256_set1_ps(aabb1.max.x);
+	__m256 aMinY = _mm256_set1_ps(aabb1.min.y), aMaxY = _mm256_set1_ps(aabb1.max.y);
+	__m256 aVelX = _mm256_set1_ps(vel1.x),		aVelY = _mm256_set1_ps(vel1.y);
+
+	for (; i + 8 <= batch.count; i += 8)
+	{
+		__m256 tFirst	= _mm256_setzero_ps();
+		__m256 tLast	= _mm256_set1_ps(dt);
+
+		sweepAxis8(aMinX, aMaxX, _mm256_loadu_ps(batch.minX + i), _mm256_loadu_ps(batch.maxX + i),
+				   _mm256_sub_ps(_mm256_loadu_ps(batch.velX + i), aVelX), tFirst, tLast);
+		sweepAxis8(aMinY, aMaxY, _mm256_loadu_ps(batch.minY + i), _mm256_loadu_ps(batch.maxY + i),
+				   _mm256_sub_ps(_mm256_loadu_ps(batch.velY + i), aVelY), tFirst, tLast);
+
+		unsigned int bits = (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(tFirst, tLast, _CMP_LE_OQ));
+		_mm256_storeu_ps(pTFirst + i, tFirst);
+
+		pHitMask[i / 32] |= bits << (i % 32);
+		for (; bits; bits &= bits - 1)
+			hitNum++;
 	}
+#elif COLLISION_BATCH_WIDTH == 4
+	__m128 aMinX = _mm_set1_ps(aabb1.min.x), aMaxX = _mm_set1_ps(aabb1.max.x);
+	__m128 aMinY = _mm_set1_ps(aabb1.min.y), aMaxY = _mm_set1_ps(aabb1.max.y);
+	__m128 aVelX = _mm_set1_ps(vel1.x),		 aVelY = _mm_set1_ps(vel1.y);
 
-	// y-axis test repeat step 3
-	// step 3
-	if (relative_vel.y < 0) {
-		// case 1
-		if (a_min_y > b_max_y) {
-			return 0;
-		}
-		// case 4 - revisited
-		if (a_max_y < b_min_y) {
-			t_first = max((a_max_y - b_min_y) / relative_vel.y, t_first);
-		}
-		if (a_min_y < b_max_y) {
-			t_last = min((a_min_y - b_max_y) / relative_vel.y, t_last);
-		}
+	for (; i + 4 <= batch.count; i += 4)
+	{
+		__m128 tFirst	= _mm_setzero_ps();
+		__m128 tLast	= _mm_set1_ps(dt);
+
+		sweepAxis4(aMinX, aMaxX, _mm_loadu_ps(batch.minX + i), _mm_loadu_ps(batch.maxX + i),
+				   _mm_sub_ps(_mm_loadu_ps(batch.velX + i), aVelX), tFirst, tLast);
+		sweepAxis4(aMinY, aMaxY, _mm_loadu_ps(batch.minY + i), _mm_loadu_ps(batch.maxY + i),
+				   _mm_sub_ps(_mm_loadu_ps(batch.velY + i), aVelY), tFirst, tLast);
+
+		unsigned int bits = (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tFirst, tLast));
+		_mm_storeu_ps(pTFirst + i, tFirst);
+
+		pHitMask[i / 32] |= bits << (i % 32);
+		for (; bits; bits &= bits - 1)
+			hitNum++;
 	}
-	else {
-		// case 2 - revisited
-		if (a_min_y > b_max_y) {
-			t_first = max((a_min_y - b_max_y) / relative_vel.y, t_first);
-		}
-		if (a_max_y > b_min_y) {
-			t_last = min((a_max_y - b_min_y) / relative_vel.y, t_last);
-		}
-		// case 3
-		if (a_max_y < b_min_y) {
-			return 0;
+#endif
+
+	// boxes left over
+	for (; i < batch.count; i++)
+	{
+		AABB	aabb2;
+		AEVec2	vel2;
+
+		aabb2.min.x = batch.minX[i];	aabb2.min.y = batch.minY[i];
+		aabb2.max.x = batch.maxX[i];	aabb2.max.y = batch.maxY[i];
+		vel2.x		= batch.velX[i];	vel2.y		= batch.velY[i];
+
+		if (CollisionIntersection_RectRect(aabb1, vel1, aabb2, vel2, dt, pTFirst[i]))
+		{
+			pHitMask[i / 32] |= 1u << (i % 32);
+			hitNum++;
 		}
 	}
-	// case 5
-	if (t_first > t_last) {
-		return 0;
+
+#if defined(DEBUG) | defined(_DEBUG)
+	// the vector paths must agree with the scalar test on every box
+	for (unsigned int k = 0; k < batch.count; k++)
+	{
+		AABB	aabb2;
+		AEVec2	vel2;
+		float	tFirst;
+
+		aabb2.min.x = batch.minX[k];	aabb2.min.y = batch.minY[k];
+		aabb2.max.x = batch.maxX[k];	aabb2.max.y = batch.maxY[k];
+		vel2.x		= batch.velX[k];	vel2.y		= batch.velY[k];
+
+		bool hit		= CollisionIntersection_RectRect(aabb1, vel1, aabb2, vel2, dt, tFirst);
+		bool batchHit	= (pHitMask[k / 32] >> (k % 32)) & 1;
+
+		AE_ASSERT_MESG(hit == batchHit && (!hit || tFirst == pTFirst[k]), "batch collision test disagrees with the scalar test!!");
 	}
-	return 1;
-}
\ No newline at end of file
+#endif
+
+	return hitNum;
+}
+
+/**************************************************************************/
+/*!
+	Vector unit the build uses, the headless check reports it
+	*/
+/**************************************************************************/
+unsigned int CollisionBatchWidth(void)
+{
+	return COLLISION_BATCH_WIDTH;
+}
@@ -0,0 +1,256 @@
+/* Start Header **************************************************************/
+/*!
+\file	Font.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file reads the glyph metrics written by Tools/FontPack.py:
+
+	font <image> <width> <height> <size> <ascent> <descent> <line height>
+	<code> <x> <y> <width> <height> <bearing x> <bearing y> <advance>
+	...
+
+in pixels, x y from the top left of the image, the bearings from the pen
+on the baseline with y up. Lines starting with '#' are comments.
+Characters without a glyph are drawn as '?'.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Font.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	FONT_GLYPH_NUM_MAX		= 128;	// ASCII only
+const unsigned char	FONT_GLYPH_MISSING		= '?';	// drawn for the characters the font does not have
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct FontGlyph
+{
+	bool				loaded;
+	AtlasRect			rect;				// texture coordinates of the glyph
+	float				width, height;		// size of the glyph in pixels
+	float				bearingX;			// from the pen to the left of the glyph
+	float				bearingY;			// from the baseline up to the top of the glyph
+	float				advance;			// pen move after the glyph
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static std::string		sFontImage;						// path of the glyph image
+static float			sFontLineHeight;				// baseline to baseline, in pixels
+static FontGlyph		sFontGlyphs[FONT_GLYPH_NUM_MAX];
+
+/******************************************************************************/
+/*!
+	Glyph drawn for "c"
+*/
+/******************************************************************************/
+static const FontGlyph & fontGlyph(char c)
+{
+	unsigned char code = (unsigned char)c;
+
+	if (code < FONT_GLYPH_NUM_MAX && sFontGlyphs[code].loaded)
+		return sFontGlyphs[code];
+
+	return sFontGlyphs[FONT_GLYPH_MISSING];
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool FontLoad(const char * pFileName)
+{
+	FontUnload();
+
+	std::ifstream file(pFileName);
+	if (!file)
+		return false;
+
+	// the image sits next to its description
+	std::string dir(pFileName);
+	size_t slash = dir.find_last_of("/\\");
+	dir = (slash == std::string::npos) ? std::string() : dir.substr(0, slash + 1);
+
+	float width = 0.0f, height = 0.0f;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string name;
+		fields >> name;
+
+		if (name == "font")
+		{
+			std::string image;
+			float size, ascent, descent;
+			fields >> image >> width >> height >> size >> ascent >> descent >> sFontLineHeight;
+			sFontImage = dir + image;
+		}
+		else
+		{
+			unsigned int code = (unsigned int)strtoul(name.c_str(), nullptr, 10);
+			float x, y;
+
+			FontGlyph glyph;
+			fields >> x >> y >> glyph.width >> glyph.height >> glyph.bearingX >> glyph.bearingY >> glyph.advance;
+
+			// the glyphs come after the image size
+			if (width <= 0.0f || height <= 0.0f || code >= FONT_GLYPH_NUM_MAX)
+				fields.setstate(std::ios::failbit);
+
+			glyph.loaded	= true;
+			glyph.rect.u0	= x / width;
+			glyph.rect.v0	= y / height;
+			glyph.rect.u1	= (x + glyph.width) / width;
+			glyph.rect.v1	= (y + glyph.height) / height;
+
+			if (!fields.fail())
+				sFontGlyphs[code] = glyph;
+		}
+
+		if (fields.fail())
+		{
+			FontUnload();
+			return false;
+		}
+	}
+
+	if (sFontImage.empty() || !sFontGlyphs[FONT_GLYPH_MISSING].loaded)
+	{
+		FontUnload();
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+const char * FontGetImage(void)
+{
+	return sFontImage.c_str();
+}
+
+/******************************************************************************/
+/*!
+	The lines of a text with several are as wide as the widest one, the
+	height goes from the lowest glyph of the last line to the tallest of
+	the first
+*/
+/******************************************************************************/
+void FontGetPrintSize(const char * pText, float scale, const SimBounds & view, float & width, float & height)
+{
+	AE_ASSERT_PARM(pText);
+
+	float penX = 0.0f, baseline = 0.0f;
+	float right = 0.0f, top = 0.0f, bottom = 0.0f;
+	bool ink = false;
+
+	for (const char * pChar = pText; *pChar; pChar++)
+	{
+		if (*pChar == '\n')
+		{
+			penX = 0.0f;
+			baseline -= sFontLineHeight;
+			continue;
+		}
+
+		const FontGlyph & glyph = fontGlyph(*pChar);
+
+		if (glyph.height > 0.0f)
+		{
+			float glyphTop		= baseline + glyph.bearingY;
+			float glyphBottom	= glyphTop - glyph.height;
+
+			top		= ink ? max(top, glyphTop) : glyphTop;
+			bottom	= ink ? min(bottom, glyphBottom) : glyphBottom;
+			ink		= true;
+		}
+
+		penX	+= glyph.advance;
+		right	= max(right, penX);
+	}
+
+	// pixels to the -1..1 window units
+	width	= right * scale * 2.0f / (view.maxX - view.minX);
+	height	= (top - bottom) * scale * 2.0f / (view.maxY - view.minY);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void FontPrint(unsigned int sprite, const char * pText, float x, float y, float scale, const SimBounds & view)
+{
+	AE_ASSERT_PARM(pText);
+
+	// the -1..1 window units to the world
+	float startX	= 0.5f * (view.minX + view.maxX) + x * 0.5f * (view.maxX - view.minX);
+	float penX		= startX;
+	float baseline	= 0.5f * (view.minY + view.maxY) + y * 0.5f * (view.maxY - view.minY);
+
+	for (const char * pChar = pText; *pChar; pChar++)
+	{
+		if (*pChar == '\n')
+		{
+			penX		= startX;
+			baseline	-= sFontLineHeight * scale;
+			continue;
+		}
+
+		const FontGlyph & glyph = fontGlyph(*pChar);
+
+		if (glyph.width > 0.0f && glyph.height > 0.0f)
+		{
+			float minX = penX + glyph.bearingX * scale;
+			float maxY = baseline + glyph.bearingY * scale;
+
+			SpriteBatchAddRect(sprite, minX, maxY - glyph.height * scale, minX + glyph.width * scale, maxY, glyph.rect);
+		}
+
+		penX += glyph.advance * scale;
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void FontUnload(void)
+{
+	sFontImage.clear();
+	sFontLineHeight = 0.0f;
+
+	for (unsigned int i = 0; i < FONT_GLYPH_NUM_MAX; i++)
+		sFontGlyphs[i].loaded = false;
+}
@@ -13,24 +13,28 @@ The functions include:
 	\n Create the asteroid game object (shape)
 	\n Create the bullet game object (shape)
 	\n Create normalized shapes, which means all the vertices' coordinates in the [-0.5;0.5] range. Use the object instances' scale values to resize the shape.
+	\n Every sprite comes from one texture atlas, the game objects keep their UV rectangle in it.
+	\n The HUD font comes from a glyph image (see Font.h).
+	\n The textures come from the asset cache (see Asset.h), their images decoded while the rest is set up.
 
 \li \c void GameStateAsteroidsInit(void);
 	\n Create 4 initial asteroids instances with defined positions and velocities.
 	\n Every asteroid have a different size, position, and velocity.
 
 \li \c void GameStateAsteroidsUpdate(void);
-	\n Update the ship's acceleration/velocity/orientation according to user input.
+	\n Turn the user input into a SimInput and step the simulation (see Simulation.h).
 	\n Uses : AEInputCheckCurr: Checks pressed keys.
 	\n		: AEInputCheckTriggered: Checks triggered keys.
 
 \li \c void GameStateAsteroidsDraw(void);
-	\n Draw the object instance using the "AEGfxMeshDraw" function.
+	\n Draw the object instances and the HUD text through the sprite batch, one "AEGfxMeshDraw" per run.
 
 \li \c void GameStateAsteroidsFree(void);
-	\n Kill each active game object instance using the "gameObjInstDestroy" function.
+	\n Nothing to free: the object instances stay until Init restarts the round over the same pool, or Unload frees it.
 
 \li \c void GameStateAsteroidsUnload(void);
-	\n Free each used game object (shape) using the "AEGfxMeshFree" function.
+	\n Kill each game object instance and free the pool using the "SimulationFree" function.
+	\n Release each texture to the asset cache, which unloads it unless the next state uses it too.
 
 Copyright (C) 20xx DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -39,9 +43,19 @@ Technology is prohibited.
 */
 /* End Header ****************************************************************/
 
+
 #include "main.h"
 #include "GameStateMgr.h"
+#include "Simulation.h"
+#include "Broadphase.h"
+#include "SpriteBatch.h"
+#include "Atlas.h"
+#include "Font.h"
+#include "Asset.h"
+#include "Profile.h"
 #include <iostream>
+#include <vector>
+#include <time.h>
 
 /******************************************************************************/
 /*!
@@ -49,25 +63,10 @@ Technology is prohibited.
 */
 /******************************************************************************/
 const unsigned int	GAME_OBJ_NUM_MAX		= 32;			//The total number of different objects (Shapes)
-const unsigned int	GAME_OBJ_INST_NUM_MAX	= 2048;			//The total number of different game object instances
-
-
-const unsigned int	SHIP_INITIAL_NUM		= 3;			// initial number of ship lives
-const float			SHIP_SIZE				= 60.0f;		// ship size
-const float			SHIP_ACCEL_FORWARD		= 1.5f;			// ship forward acceleration (in m/s^2)
-const float			SHIP_ACCEL_BACKWARD		= 3.0f;			// ship backward acceleration (in m/s^2)
-const float			SHIP_ROT_SPEED			= (2.0f * PI);	// ship rotation speed (degree/second)
+const unsigned int	BATCH_MESH_NONE			= 0xFFFFFFFF;	//Run holding no mesh of "sBatchMeshList"
 
-const float			BULLET_SPEED			= 10.0f;			// bullet speed (m/s)
-const float			BULLET_SIZE				= 15.0f;			
+const char *		FONT_FILE				= "../Resources/Fonts/Strawberry_Muffins_Demo_20.txt";	// glyphs made by Tools/FontPack.py
 
-const float			ASTEROID_SIZE			= 100.0f;
-float				ASTEROID_FRAME			= 1.0f;
-float				ASTEROID_FRAME_MAX		= 1.0f;
-int					ASTEROID_COUNTER		= 10;
-
-bool				PRINT					= false;
-bool				GAMEOVER				= true;
 bool				RESTART					= false;
 
 float				GAMEOVERTIMER			= 0.0f;
@@ -76,20 +75,16 @@ bool				SPAWN2					= false;
 bool				SPAWN3					= false;
 bool				SPAWN4					= false;
 
-char fontId = 0;
-f32 TextWidth, TextHeight;
 
 
 
 
 // -----------------------------------------------------------------------------
-enum TYPE
+// the simulated types (TYPE_SHIP, TYPE_BULLET, TYPE_ASTEROID) come from
+// Simulation.h, the game over panels are only drawn
+enum TYPE_PANEL
 {
-	// list of game object types
-	TYPE_SHIP = 0, 
-	TYPE_BULLET,
-	TYPE_ASTEROID,
-	TYPE_GAMEOVER1,
+	TYPE_GAMEOVER1 = TYPE_SIM_NUM,
 	TYPE_GAMEOVER2,
 	TYPE_GAMEOVER3,
 	TYPE_GAMEOVER4,
@@ -97,10 +92,13 @@ enum TYPE
 	TYPE_NUM
 };
 
-// -----------------------------------------------------------------------------
-// object flag definition
+// sprites that are not game objects
+enum SPRITE
+{
+	SPRITE_TEXT = TYPE_NUM,		// the glyph image, the font draws parts of it
 
-const unsigned long FLAG_ACTIVE				= 0x00000001;
+	SPRITE_NUM
+};
 
 /******************************************************************************/
 /*!
@@ -112,287 +110,386 @@ const unsigned long FLAG_ACTIVE				= 0x00000001;
 struct GameObj
 {
 	unsigned long		type;		// object type
-	AEGfxVertexList *	pMesh;		// This will hold the triangles which will form the shape of the object
-	AEGfxTexture*		pTex;
+	unsigned int		texture;	// index into "sTextureList" of the texture its sprite is in
+	AtlasRect			uv;			// part of the texture the sprite batch's quads show
+	unsigned int		layer;		// drawn over the lower layers
 };
 
+//Mesh built from a run of a static layer, shared by the runs whose vertices hash the same
+struct SpriteBatchMesh
+{
+	unsigned long long	hash;		// of the vertices pMesh was built from
+	unsigned int		vertexNum;
+	AEGfxVertexList *	pMesh;		// nullptr when the entry is free
+	unsigned int		refNum;		// runs drawing it, freed when none is left
+};
 
-GameObj* pObj_Asteroid;
-GameObj* pObj_Bullet;
-GameObj* pObj_Ship;
-
-
-// ---------------------------------------------------------------------------
+//Line of HUD text showing one value, formatted and measured only when the value changes
+struct HudText
+{
+	long				value;		// value the text was made from
+	bool				valid;		// false until the text is made, and after the font changes
+	char				text[64];
+	f32					width;		// size of the text as printed, in normalized window units
+	f32					height;
+};
 
-//Game object instance structure
-struct GameObjInst
+// sprite batch layers, drawn in this order
+enum LAYER
 {
-	GameObj *			pObject;	// pointer to the 'original' shape
-	unsigned long		flag;		// bit flag or-ed together
-	float				scale;		// scaling value of the object instance
-	AEVec2				posCurr;	// object current position
-	AEVec2				velCurr;	// object current velocity
-	float				dirCurr;	// object current direction
-	AABB				boundingBox;// object bouding box that encapsulates the object
-	AEMtx33				transform;	// object transformation matrix: Each frame, 
-									// calculate the object instance's transformation matrix and save it here
-
-	//void				(*pfUpdate)(void);
-	//void				(*pfDraw)(void);
+	LAYER_WORLD = 0,
+	LAYER_PANEL,
+	LAYER_HUD,
 };
 
+
+GameObj* pObj_Asteroid;
+GameObj* pObj_Bullet;
+GameObj* pObj_Ship;
+
 /******************************************************************************/
 /*!
 	Static Variables
 */
 /******************************************************************************/
 
-// list of original object
+// list of original object, indexed by type
 static GameObj				sGameObjList[GAME_OBJ_NUM_MAX];				// Each element in this array represents a unique game object (shape)
 static unsigned long		sGameObjNum;								// The number of defined game objects
 
-// list of object instances
-static GameObjInst			sGameObjInstList[GAME_OBJ_INST_NUM_MAX];	// Each element in this array represents a unique game object instance (sprite)
-static unsigned long		sGameObjInstNum;							// The number of used game object instances
-
-// pointer to the ship object
-static GameObjInst *			spShip;									// Pointer to the "Ship" game object instance
-// number of ship available (lives 0 = game over)
-static long					sShipLives;									// The number of lives left
+// loaded textures, the game objects refer to them by index
+static AEGfxTexture *		sTextureList[SPRITE_BATCH_TEXTURE_MAX];
+static unsigned int			sTextureNum;
 
-// the score = number of asteroid destroyed
-static unsigned long		sScore;										// Current score
+// meshes of the panel and HUD runs, looked up by the hash of their vertices
+static std::vector<SpriteBatchMesh>	sBatchMeshList;
+static unsigned int			sBatchRunMesh[SPRITE_BATCH_RUN_MAX];		// entry each run drew last, BATCH_MESH_NONE for none
 
+// lines of the HUD
+static HudText				sHudLives;
+static HudText				sHudScore;
 
-
-// ---------------------------------------------------------------------------
-
-// functions to create/destroy a game object instance
-GameObjInst *		gameObjInstCreate (unsigned long type, float scale, 
-											   AEVec2 * pPos, AEVec2 * pVel, float dir);
-void				gameObjInstDestroy(GameObjInst * pInst);
+// a fire key press waiting for a step, the frame it came in may run none
+static bool					sFireLatched;
 
 
 /******************************************************************************/
 /*!
-	"Load" function of this state
+	Builds the mesh of "vertexNum" world space vertices
 */
 /******************************************************************************/
-void GameStateAsteroidsLoad(void)
+static AEGfxVertexList * spriteBatchMeshBuild(const SpriteVertex * pVertices, unsigned int vertexNum)
 {
-	// zero the game object array
-	memset(sGameObjList, 0, sizeof(GameObj) * GAME_OBJ_NUM_MAX);
-	// No game objects (shapes) at this point
-	sGameObjNum = 0;
-
-	// zero the game object instance array
-	memset(sGameObjInstList, 0, sizeof(GameObjInst) * GAME_OBJ_INST_NUM_MAX);
-	// No game object instances (sprites) at this point
-	sGameObjInstNum = 0;
-
-	// The ship object instance hasn't been created yet, so this "spShip" pointer is initialized to 0
-	spShip = nullptr;
-
-	// load/create the mesh data (game objects / Shapes)
-
-	// =====================
-	// create the ship shape
-	// =====================
-
-	pObj_Ship		= sGameObjList + sGameObjNum++;
-
-	pObj_Ship->type	= TYPE_SHIP;
-	
-	pObj_Ship->pTex	= AEGfxTextureLoad("../Resources/Textures/Ship.png");
-
-	AE_ASSERT_MESG(pObj_Ship->pTex, "Failed to create texture1!!");
-
 	AEGfxMeshStart();
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
-
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
-
-	pObj_Ship->pMesh = AEGfxMeshEnd();
-
-	AE_ASSERT_MESG(pObj_Ship->pMesh, "fail to create object!!");
-
+	for (unsigned int k = 0; k + 2 < vertexNum; k += 3)
+	{
+		const SpriteVertex * v = pVertices + k;
 
-	// =======================
-	// create the bullet shape
-	// =======================
+		AEGfxTriAdd(
+			v[0].x, v[0].y, 0xFFFFFFFF, v[0].u, v[0].v,
+			v[1].x, v[1].y, 0xFFFFFFFF, v[1].u, v[1].v,
+			v[2].x, v[2].y, 0xFFFFFFFF, v[2].u, v[2].v);
+	}
 
+	AEGfxVertexList * pMesh = AEGfxMeshEnd();
+	AE_ASSERT_MESG(pMesh, "fail to create the sprite batch mesh!!");
 
-	// load/create the mesh data (game objects / Shapes)
+	return pMesh;
+}
 
-	pObj_Bullet = sGameObjList + sGameObjNum++;
+/******************************************************************************/
+/*!
+	64 bit FNV-1a hash of the vertices' bytes
+*/
+/******************************************************************************/
+static unsigned long long spriteBatchMeshHash(const SpriteVertex * pVertices, unsigned int vertexNum)
+{
+	const unsigned char * pByte = reinterpret_cast<const unsigned char *>(pVertices);
+	unsigned long long hash = 14695981039346656037ull;
 
-	pObj_Bullet->type = TYPE_BULLET;
+	for (size_t i = 0, byteNum = vertexNum * sizeof(SpriteVertex); i < byteNum; i++)
+	{
+		hash ^= pByte[i];
+		hash *= 1099511628211ull;
+	}
 
-	pObj_Bullet->pTex	= AEGfxTextureLoad("../Resources/Textures/Bullet.png");
+	return hash;
+}
 
-	AE_ASSERT_MESG(pObj_Bullet->pTex, "Failed to create texture1!!");
+/******************************************************************************/
+/*!
+	Drops the run's hold on its mesh, the last run holding a mesh frees it
+*/
+/******************************************************************************/
+static void spriteBatchMeshRelease(unsigned int run)
+{
+	unsigned int mesh = sBatchRunMesh[run];
 
-	AEGfxMeshStart();
+	if (mesh == BATCH_MESH_NONE)
+		return;
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+	SpriteBatchMesh & entry = sBatchMeshList[mesh];
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+	if (--entry.refNum == 0)
+	{
+		AEGfxMeshFree(entry.pMesh);
+		entry.pMesh = nullptr;
+	}
 
-	pObj_Bullet->pMesh = AEGfxMeshEnd();
+	sBatchRunMesh[run] = BATCH_MESH_NONE;
+}
 
-	AE_ASSERT_MESG(pObj_Bullet->pMesh, "fail to create object!!");
+/******************************************************************************/
+/*!
+	Mesh of a static run: the one it drew last when its vertices still hash
+	the same, else the one of another run with these vertices, else a new one
+*/
+/******************************************************************************/
+static AEGfxVertexList * spriteBatchMeshAcquire(unsigned int run, const SpriteVertex * pVertices, unsigned int vertexNum)
+{
+	unsigned long long hash = spriteBatchMeshHash(pVertices, vertexNum);
 
+	unsigned int held = sBatchRunMesh[run];
 
-	// =========================
-	// create the asteroid shape
-	// =========================
-	
+	if (held != BATCH_MESH_NONE && sBatchMeshList[held].hash == hash && sBatchMeshList[held].vertexNum == vertexNum)
+		return sBatchMeshList[held].pMesh;
 
+	spriteBatchMeshRelease(run);
 
-	pObj_Asteroid = sGameObjList + sGameObjNum++;
+	unsigned int freeMesh = BATCH_MESH_NONE;
 
-	pObj_Asteroid->type = TYPE_ASTEROID ;
+	for (unsigned int i = 0; i < sBatchMeshList.size(); i++)
+	{
+		SpriteBatchMesh & entry = sBatchMeshList[i];
 
-	pObj_Asteroid->pTex = AEGfxTextureLoad("../Resources/Textures/Asteroid.png");
+		if (!entry.pMesh)
+		{
+			if (freeMesh == BATCH_MESH_NONE)
+				freeMesh = i;
+		}
+		else if (entry.hash == hash && entry.vertexNum == vertexNum)
+		{
+			entry.refNum++;
+			sBatchRunMesh[run] = i;
 
-	AE_ASSERT_MESG(pObj_Asteroid->pTex, "Failed to create texture1!!");
+			return entry.pMesh;
+		}
+	}
 
-	AEGfxMeshStart();
+	if (freeMesh == BATCH_MESH_NONE)
+	{
+		freeMesh = (unsigned int)sBatchMeshList.size();
+		sBatchMeshList.push_back(SpriteBatchMesh());
+	}
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+	SpriteBatchMesh & entry = sBatchMeshList[freeMesh];
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+	entry.hash		= hash;
+	entry.vertexNum	= vertexNum;
+	entry.pMesh		= spriteBatchMeshBuild(pVertices, vertexNum);
+	entry.refNum	= 1;
 
-	pObj_Asteroid->pMesh = AEGfxMeshEnd();
+	sBatchRunMesh[run] = freeMesh;
 
-	AE_ASSERT_MESG(pObj_Asteroid->pMesh, "fail to create object!!");
+	return entry.pMesh;
+}
 
-	// =========================
-	// create the GAMEOVER shape
-	// =========================
-	// GAMEOVER #1
-	pObj_Asteroid = sGameObjList + sGameObjNum++;
+/******************************************************************************/
+/*!
+	Flush function of the sprite batch: the vertices are already in world
+	space, they go into one mesh drawn with the identity transform.
+	The world's sprites move every frame, their mesh is built for the frame
+	and freed. The panel and HUD only change with what they show, their
+	runs keep a mesh looked up by the hash of its vertices.
+	The texture and blend mode are only set when they changed since
+	the previous run
+*/
+/******************************************************************************/
+static void spriteBatchFlush(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum)
+{
+	AE_ASSERT_PARM(state.run < SPRITE_BATCH_RUN_MAX);
 
-	pObj_Asteroid->type = TYPE_GAMEOVER1;
+	if (state.run == 0)
+	{
+		AEMtx33 identity;
+		AEMtx33Identity(&identity);
+		AEGfxSetTransform(identity.m);
+	}
 
-	pObj_Asteroid->pTex = AEGfxTextureLoad("../Resources/Textures/Gameover1.png");
+	if (state.changed & SPRITE_BATCH_CHANGE_BLEND)
+		AEGfxSetBlendMode((AEGfxBlendMode)state.blend);
+	if (state.changed & SPRITE_BATCH_CHANGE_TEXTURE)
+		AEGfxTextureSet(sTextureList[state.texture], 0, 0);
 
-	AE_ASSERT_MESG(pObj_Asteroid->pTex, "Failed to create texture1!!");
+	if (vertexNum == 0)
+		return;
 
-	AEGfxMeshStart();
+	if (state.layer == LAYER_WORLD)
+	{
+		spriteBatchMeshRelease(state.run);
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+		AEGfxVertexList * pMesh = spriteBatchMeshBuild(pVertices, vertexNum);
+		AEGfxMeshDraw(pMesh, AE_GFX_MDM_TRIANGLES);
+		AEGfxMeshFree(pMesh);
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+		return;
+	}
 
-	pObj_Asteroid->pMesh = AEGfxMeshEnd();
+	AEGfxMeshDraw(spriteBatchMeshAcquire(state.run, pVertices, vertexNum), AE_GFX_MDM_TRIANGLES);
+}
 
-	AE_ASSERT_MESG(pObj_Asteroid->pMesh, "fail to create object!!");
-	// GAMEOVER #2
+/******************************************************************************/
+/*!
+	Formats "pFormat" with "value" into the HUD line and measures it, unless
+	it already shows that value
+*/
+/******************************************************************************/
+static const HudText & hudTextUpdate(HudText & hud, const char * pFormat, long value, const SimBounds & view)
+{
+	if (!hud.valid || hud.value != value)
+	{
+		sprintf_s(hud.text, pFormat, value);
+		FontGetPrintSize(hud.text, 1.0f, view, hud.width, hud.height);
 
-	pObj_Asteroid = sGameObjList + sGameObjNum++;
+		hud.value = value;
+		hud.valid = true;
+	}
 
-	pObj_Asteroid->type = TYPE_GAMEOVER2;
+	return hud;
+}
 
-	pObj_Asteroid->pTex = AEGfxTextureLoad("../Resources/Textures/Gameover2.png");
+#if defined(DEBUG) | defined(_DEBUG)
+/******************************************************************************/
+/*!
+	Checks the layout of the glyph font against the engine's own text
+	functions, on lines like the HUD's. Both come from the same TrueType
+	file at the same size, they may only differ by the rounding of each
+	glyph
+*/
+/******************************************************************************/
+static void fontValidate(const SimBounds & view)
+{
+	s8 engineFont = AEGfxCreateFont("../Resources/Fonts/Strawberry_Muffins_Demo.ttf", 20);
+	AE_ASSERT_MESG(engineFont >= 0, "Failed to create the engine font!!");
 
-	AE_ASSERT_MESG(pObj_Asteroid->pTex, "Failed to create texture1!!");
+	char text[][64] = { "Ship Left: 0", "Score: 1234567890", "The quick brown fox jumps over the lazy dog" };
 
-	AEGfxMeshStart();
+	float pixelX = 2.0f / (view.maxX - view.minX);
+	float pixelY = 2.0f / (view.maxY - view.minY);
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+	for (unsigned int i = 0; i < sizeof(text) / sizeof(text[0]); i++)
+	{
+		f32 engineWidth, engineHeight;
+		AEGfxGetPrintSize(engineFont, text[i], 1.0f, engineWidth, engineHeight);
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+		float width, height;
+		FontGetPrintSize(text[i], 1.0f, view, width, height);
 
-	pObj_Asteroid->pMesh = AEGfxMeshEnd();
+		AE_ASSERT_MESG(fabsf(width - engineWidth) <= pixelX * strlen(text[i]) && fabsf(height - engineHeight) <= 2.0f * pixelY,
+					   "Font layout of \"%s\" differs from the engine's!!", text[i]);
+	}
 
-	AE_ASSERT_MESG(pObj_Asteroid->pMesh, "fail to create object!!");
-	// GAMEOVER #3
+	AEGfxDestroyFont(engineFont);
+}
+#endif
 
-	pObj_Asteroid = sGameObjList + sGameObjNum++;
+/******************************************************************************/
+/*!
+	Create the game object of "type", drawn with the atlas sprite "pSprite"
+	of texture "texture", in "layer"
+*/
+/******************************************************************************/
+static GameObj * gameObjCreate(unsigned long type, const char * pSprite, unsigned int texture, unsigned int layer)
+{
+	// the list is indexed by type
+	AE_ASSERT_PARM(type == sGameObjNum);
 
-	pObj_Asteroid->type = TYPE_GAMEOVER3;
+	GameObj * pObj = sGameObjList + sGameObjNum++;
 
-	pObj_Asteroid->pTex = AEGfxTextureLoad("../Resources/Textures/Gameover3.png");
+	pObj->type		= type;
+	pObj->texture	= texture;
+	pObj->layer		= layer;
 
-	AE_ASSERT_MESG(pObj_Asteroid->pTex, "Failed to create texture1!!");
+	bool found = AtlasFind(pSprite, pObj->uv);
+	AE_ASSERT_MESG(found, "Sprite %s is not in the atlas!!", pSprite);
 
-	AEGfxMeshStart();
+	SpriteBatchSetSprite(type, texture, pObj->uv, layer, AE_GFX_BM_BLEND);
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+	return pObj;
+}
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+/******************************************************************************/
+/*!
+	"Load" function of this state
+*/
+/******************************************************************************/
+void GameStateAsteroidsLoad(void)
+{
+	// zero the game object array
+	memset(sGameObjList, 0, sizeof(GameObj) * GAME_OBJ_NUM_MAX);
+	// No game objects (shapes) at this point
+	sGameObjNum = 0;
+	sTextureNum = 0;
 
-	pObj_Asteroid->pMesh = AEGfxMeshEnd();
+	// no run holds a mesh yet
+	for (unsigned int i = 0; i < SPRITE_BATCH_RUN_MAX; i++)
+		sBatchRunMesh[i] = BATCH_MESH_NONE;
 
-	AE_ASSERT_MESG(pObj_Asteroid->pMesh, "fail to create object!!");
-	// GAMEOVER #4
+	// =============================================
+	// load the atlas every sprite is packed into
+	// (made by Tools/AtlasPack.py)
+	// =============================================
 
-	pObj_Asteroid = sGameObjList + sGameObjNum++;
+	// the descriptions are small, the images are decoded in the
+	// background, if not already textures, and acquired at the end of the load
 
-	pObj_Asteroid->type = TYPE_GAMEOVER4;
+	bool atlasLoaded = AtlasLoad("../Resources/Textures/Atlas.txt");
+	AE_ASSERT_MESG(atlasLoaded, "Failed to read the texture atlas!!");
+	AssetTexturePrefetch(AtlasGetImage());
 
-	pObj_Asteroid->pTex = AEGfxTextureLoad("../Resources/Textures/Gameover4.png");
+	bool fontLoaded = FontLoad(FONT_FILE);
+	AE_ASSERT_MESG(fontLoaded, "Failed to read the font!!");
+	AssetTexturePrefetch(FontGetImage());
 
-	AE_ASSERT_MESG(pObj_Asteroid->pTex, "Failed to create texture1!!");
+	unsigned int atlas	= sTextureNum++;
+	unsigned int font	= sTextureNum++;
 
-	AEGfxMeshStart();
+	// ==============================================
+	// create the game objects, a sprite of the atlas
+	// each, in type order
+	// ==============================================
 
-	AEGfxTriAdd(
-		-0.5f, -0.5f, 0x00FF00FF, 0.0f, 1.0f,
-		0.5f, -0.5f, 0x00FFFF00, 1.0f, 1.0f,
-		-0.5f, 0.5f, 0x0000FFFF, 0.0f, 0.0f);
+	pObj_Ship		= gameObjCreate(TYPE_SHIP,		"Ship",		atlas,	LAYER_WORLD);
+	pObj_Bullet		= gameObjCreate(TYPE_BULLET,	"Bullet",	atlas,	LAYER_WORLD);
+	pObj_Asteroid	= gameObjCreate(TYPE_ASTEROID,	"Asteroid",	atlas,	LAYER_WORLD);
 
-	AEGfxTriAdd(
-		0.5f, -0.5f, 0x00FFFFFF, 1.0f, 1.0f,
-		0.5f, 0.5f, 0x00FFFFFF, 1.0f, 0.0f,
-		-0.5f, 0.5f, 0x00FFFFFF, 0.0f, 0.0f);
+	gameObjCreate(TYPE_GAMEOVER1,	"Gameover1",	atlas,	LAYER_PANEL);
+	gameObjCreate(TYPE_GAMEOVER2,	"Gameover2",	atlas,	LAYER_PANEL);
+	gameObjCreate(TYPE_GAMEOVER3,	"Gameover3",	atlas,	LAYER_PANEL);
+	gameObjCreate(TYPE_GAMEOVER4,	"Gameover4",	atlas,	LAYER_PANEL);
 
-	pObj_Asteroid->pMesh = AEGfxMeshEnd();
+	// the font's glyphs are one more texture, the text is one more sprite
+	AtlasRect wholeTexture = { 0.0f, 0.0f, 1.0f, 1.0f };
+	SpriteBatchSetSprite(SPRITE_TEXT, font, wholeTexture, LAYER_HUD, AE_GFX_BM_BLEND);
 
-	AE_ASSERT_MESG(pObj_Asteroid->pMesh, "fail to create object!!");
+#if defined(DEBUG) | defined(_DEBUG)
+	SimBounds view = { AEGfxGetWinMinX(), AEGfxGetWinMinY(), AEGfxGetWinMaxX(), AEGfxGetWinMaxY() };
+	fontValidate(view);
+#endif
 
+	sTextureList[atlas] = AssetTextureAcquire(AtlasGetImage());
+	AE_ASSERT_MESG(sTextureList[atlas], "Failed to create the atlas texture!!");
 
+	sTextureList[font] = AssetTextureAcquire(FontGetImage());
+	AE_ASSERT_MESG(sTextureList[font], "Failed to create the font texture!!");
 
+	// the rectangles are kept on the game objects
+	AtlasUnload();
 
-	fontId = AEGfxCreateFont("../Resources/Fonts/Strawberry_Muffins_Demo.ttf", 20);
+	// measured with the old font, if any
+	sHudLives.valid = false;
+	sHudScore.valid = false;
 
 }
 
@@ -403,19 +500,14 @@ void GameStateAsteroidsLoad(void)
 /******************************************************************************/
 void GameStateAsteroidsInit(void)
 {
-	// create the main ship
-	spShip		= gameObjInstCreate(TYPE_SHIP, SHIP_SIZE, nullptr, nullptr, 0.0f);
-	AE_ASSERT(spShip);	
-
-	// CREATE THE INITIAL ASTEROIDS INSTANCES USING THE "gameObjInstCreate" FUNCTION
+	// the simulated world is the window
+	SimBounds bounds = { AEGfxGetWinMinX(), AEGfxGetWinMinY(), AEGfxGetWinMaxX(), AEGfxGetWinMaxY() };
 
-	// reset the score and the number of ships
-	sScore      = 0;
-	sShipLives  = SHIP_INITIAL_NUM;
+	// create the main ship, reset the score and the number of ships
+	SimulationInit(bounds, (unsigned int)time(nullptr));
 
-	GAMEOVER = true;
 	RESTART = false;
-	ASTEROID_COUNTER = 10;
+	sFireLatched = false;
 	SPAWN1 = false;
 	SPAWN2 = false;
 	SPAWN3 = false;
@@ -425,322 +517,53 @@ void GameStateAsteroidsInit(void)
 
 /******************************************************************************/
 /*!
-	"Update" function of this state
+	Takes the keys triggered this display frame, once per frame: on its
+	first step, or in the draw when it runs no step
 */
 /******************************************************************************/
-void GameStateAsteroidsUpdate(void)
+static void inputLatch(void)
 {
-
-	// =========================
-	// update according to input
-	// =========================
-
-	// This input handling moves the ship without any velocity nor acceleration
-	// It should be changed when implementing the Asteroids project
-	//
-	// Updating the velocity and position according to acceleration is 
-	// done by using the following:
-	// Pos1 = 1/2 * a*t*t + v0*t + Pos0
-	//
-	// In our case we need to divide the previous equation into two parts in order 
-	// to have control over the velocity and that is done by:
-	//
-	// v1 = a*t + v0		//This is done when the UP or DOWN key is pressed 
-	// Pos1 = v1*t + Pos0
-
-if(GAMEOVER)
-{ 
-	if (AEInputCheckCurr(AEVK_UP))
+	// cycle through the broadphase modes
+	if (AEInputCheckTriggered(AEVK_B))
 	{
-		AEVec2 added;
-		AEVec2Set(&added, cosf(spShip->dirCurr), sinf(spShip->dirCurr));  // current orientation α to compute the normalized acceleration vector
-		AEVec2Scale(&added, &added, SHIP_ACCEL_FORWARD); // Scaling by a predefined value will give the full acceleration vector
-		AEVec2Scale(&added, &added, (float)(AEFrameRateControllerGetFrameTime())); //a*dt
-		AEVec2Add(&spShip->velCurr, &added, &spShip->velCurr); //newVel = a*dt + currVel
+		SimulationSetBroadphaseMode((SimulationGetBroadphaseMode() + 1) % BROADPHASE_MODE_NUM);
+		std::cout << "Broadphase: " << BroadphaseModeName(SimulationGetBroadphaseMode()) << std::endl;
 	}
 
-	if (AEInputCheckCurr(AEVK_DOWN))
-	{
-		AEVec2 added;
-		AEVec2Set(&added, -cosf(spShip->dirCurr), -sinf(spShip->dirCurr));  // current orientation α to compute the normalized acceleration vector
-		AEVec2Scale(&added, &added, SHIP_ACCEL_BACKWARD); // Scaling by a predefined value will give the full acceleration vector
-		AEVec2Scale(&added, &added, (float)(AEFrameRateControllerGetFrameTime())); //a*dt
-		AEVec2Add(&spShip->velCurr, &added, &spShip->velCurr); //newVel = a*dt + currVel
-	}
-
-	if (AEInputCheckCurr(AEVK_LEFT))
-	{
-		spShip->dirCurr += SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime ());
-		spShip->dirCurr =  AEWrap(spShip->dirCurr, -PI, PI);
-	}
-
-	if (AEInputCheckCurr(AEVK_RIGHT))
-	{
-		spShip->dirCurr -= SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime ());
-		spShip->dirCurr =  AEWrap(spShip->dirCurr, -PI, PI);
-	}
-			
-	
-	// Shoot a bullet if space is triggered (Create a new object instance)
 	if (AEInputCheckTriggered(AEVK_SPACE))
-	{
-		GameObjInst* spBullet;
-		spBullet = gameObjInstCreate(TYPE_BULLET, BULLET_SIZE, nullptr, nullptr, 0.0f);
-		AE_ASSERT(spBullet);
-		spBullet->dirCurr = spShip->dirCurr;
-		spBullet->posCurr = spShip->posCurr;
-		AEVec2 added;
-		AEVec2Set(&added, cosf(spShip->dirCurr), sinf(spShip->dirCurr));
-		AEVec2Scale(&spBullet->velCurr,&added, BULLET_SPEED);
-		// Get the bullet's direction according to the ship's direction
-		// Set the velocity
-		// Create an instance
-	}
-
-	if ((ASTEROID_FRAME -= (float)AEFrameRateControllerGetFrameTime())<0)
-	{
-		ASTEROID_FRAME = ASTEROID_FRAME_MAX;
-
-		if (ASTEROID_COUNTER-- >= 0)
-		{
-
-			float random = AERandFloat();
-			AEVec2 pos;
-			if (AERandFloat() < 0.5f) {
-				// horizontal
-				if (AERandFloat() < 0.5f) {
-					// negative
-					AEVec2Set(&pos, AEGfxGetWinMinX() - ASTEROID_SIZE, AERandFloat() * AEGetWindowHeight());
-				}
-				else { // positive
-					AEVec2Set(&pos, AEGfxGetWinMaxX() + ASTEROID_SIZE, AERandFloat() * AEGetWindowHeight());
-				}
-			}
-			else {
-				// vertical
-				if (AERandFloat() < 0.5f) {
-					AEVec2Set(&pos, AERandFloat() * AEGetWindowWidth(), AEGfxGetWinMinY() - ASTEROID_SIZE);
-				}
-				else {
-					AEVec2Set(&pos, AERandFloat() * AEGetWindowWidth(), AEGfxGetWinMaxY() + ASTEROID_SIZE);
-				}
-			}
-			GameObjInst* spAsteroid;
-			spAsteroid = gameObjInstCreate(TYPE_ASTEROID, ASTEROID_SIZE, &pos, nullptr, 0.0f);
-			AE_ASSERT(spAsteroid);
-			AEVec2 added;
-			AEVec2Set(&added, -cosf(random * 360), -sinf(random * 360));
-			AEVec2Scale(&spAsteroid->velCurr, &added, 1.0f);
-			AEVec2Add(&spAsteroid->posCurr , &spAsteroid->velCurr, &spAsteroid->posCurr);
-		}
-	}
+		sFireLatched = true;
 }
 
-	// ======================================================
-	// update physics of all active game object instances
-	//	-- Positions are updated here with the computed velocity
-	//  -- Get the bounding rectangle of every active instance:
-	//		boundingRect_min = -BOUNDING_RECT_SIZE * instance->scale + instance->pos
-	//		boundingRect_max = BOUNDING_RECT_SIZE * instance->scale + instance->pos
-	// ======================================================
-
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst* pInst = sGameObjInstList + i;
-
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
-
-		pInst->boundingBox.min.x = -0.5f * pInst->scale + pInst->posCurr.x;
-		pInst->boundingBox.min.y = -0.5f * pInst->scale + pInst->posCurr.y;
-		pInst->boundingBox.max.x = 0.5f * pInst->scale + pInst->posCurr.x;
-		pInst->boundingBox.max.y = 0.5f * pInst->scale + pInst->posCurr.y;
-
-
-		if (pInst->pObject->type == TYPE_BULLET)
-		{
-			for (unsigned long j = 0; j < GAME_OBJ_INST_NUM_MAX; j++)
-			{
-				GameObjInst* pInstj = sGameObjInstList + j;
-
-				// skip non-active object
-				if ((pInstj->flag & FLAG_ACTIVE) == 0)
-					continue;
-
-				if (pInstj->pObject->type == TYPE_ASTEROID)
-				{
-					if (CollisionIntersection_RectRect(pInstj->boundingBox, pInstj->velCurr, pInst->boundingBox, pInst->velCurr))
-					{
-						gameObjInstDestroy(pInstj);
-						gameObjInstDestroy(pInst);
-						sScore++;
-						if (sScore >= 5000)
-						{
-							std::cout << "You Rock!" << std::endl;
-						}
-						ASTEROID_COUNTER ++;
-					}
-				}
-			}
-		}
-
-		if (pInst->pObject->type == TYPE_ASTEROID)
-		{
-			if (CollisionIntersection_RectRect(spShip->boundingBox, spShip->velCurr, pInst->boundingBox, pInst->velCurr))
-			{
-				gameObjInstDestroy(pInst);
-				sShipLives--;
-				AEVec2Set(&spShip->posCurr,0.0f,0.0f);
-				AEVec2Set(&spShip->velCurr, 0.0f, 0.0f);
-				PRINT = true ;
-				ASTEROID_COUNTER++;
-			}
-		}
-	}
-
-
-
-
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst* pInst = sGameObjInstList + i;
-
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
-
-
-		// check if the object is a ship
-		if (pInst->pObject->type == TYPE_BULLET) 
-		{
-			AEVec2Add(&pInst->posCurr,&pInst->posCurr,&pInst->velCurr);
-		}
-
-		if (pInst->pObject->type == TYPE_ASTEROID)
-		{
-			AEVec2Add(&pInst->posCurr, &pInst->posCurr, &pInst->velCurr);
-		}
-	}
-
-	
-	spShip->velCurr.x *= 0.99f;
-	spShip->velCurr.y *= 0.99f;
-	
-	AEVec2Add(&spShip->posCurr, &spShip->velCurr, &spShip->posCurr);
-	
-
-	// ===================================
-	// update active game object instances
-	// Example:
-	//		-- Wrap specific object instances around the world (Needed for the assignment)
-	//		-- Removing the bullets as they go out of bounds (Needed for the assignment)
-	//		-- If you have a homing missile for example, compute its new orientation 
-	//			(Homing missiles are not required for the Asteroids project)
-	//		-- Update a particle effect (Not required for the Asteroids project)
-	// ===================================
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst * pInst = sGameObjInstList + i;
-
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
-		
-		// check if the object is a ship
-		if (pInst->pObject->type == TYPE_SHIP)
-		{
-			// warp the ship from one end of the screen to the other
-			pInst->posCurr.x = AEWrap(pInst->posCurr.x, AEGfxGetWinMinX() - SHIP_SIZE, 
-														AEGfxGetWinMaxX() + SHIP_SIZE);
-			pInst->posCurr.y = AEWrap(pInst->posCurr.y, AEGfxGetWinMinY() - SHIP_SIZE, 
-														AEGfxGetWinMaxY() + SHIP_SIZE);
-		}
-
-		// Wrap asteroids here
-		if (pInst->pObject->type == TYPE_ASTEROID)
-		{
-			// warp the ship from one end of the screen to the other
-			pInst->posCurr.x = AEWrap(pInst->posCurr.x, AEGfxGetWinMinX() - ASTEROID_SIZE,
-				AEGfxGetWinMaxX() + ASTEROID_SIZE);
-			pInst->posCurr.y = AEWrap(pInst->posCurr.y, AEGfxGetWinMinY() - ASTEROID_SIZE,
-				AEGfxGetWinMaxY() + ASTEROID_SIZE);
-		}
-			
-
-		// Remove bullets that go out of bounds
-		if (pInst->pObject->type == TYPE_BULLET)
-		{
-			if (pInst->posCurr.x + BULLET_SIZE <= AEGfxGetWinMinX() || pInst->posCurr.x - BULLET_SIZE >= AEGfxGetWinMaxX() ||
-				pInst->posCurr.y + BULLET_SIZE <= AEGfxGetWinMinY() || pInst->posCurr.y - BULLET_SIZE >= AEGfxGetWinMaxY())
-			{
-				gameObjInstDestroy(pInst);
-			}
-		}
-
-	}
-
-
-
-	// ====================
-	// check for collision
-	// ====================
-	
-	/*
-	for each object instance: oi1
-		if oi1 is not active
-			skip
-
-		if oi1 is an asteroid
-			for each object instance oi2
-				if(oi2 is not active or oi2 is an asteroid)
-					skip
-
-				if(oi2 is the ship)
-					Check for collision between ship and asteroids (Rectangle - Rectangle)
-					Update game behavior accordingly
-					Update "Object instances array"
-				else
-				if(oi2 is a bullet)
-					Check for collision between ship and asteroids (Rectangle - Rectangle)
-					Update game behavior accordingly
-					Update "Object instances array"
-	*/
-
-
-
-	// =====================================
-	// calculate the matrix for all objects
-	// =====================================
-
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst * pInst = sGameObjInstList + i;
-		AEMtx33		 trans, rot, scale;
-
-		/*UNREFERENCED_PARAMETER(trans);
-		UNREFERENCED_PARAMETER(rot);
-		UNREFERENCED_PARAMETER(scale);*/
-
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
-
-		// Compute the scaling matrix
-		AEMtx33Scale(&scale , pInst->scale , pInst->scale);
+/******************************************************************************/
+/*!
+	"Update" function of this state
+*/
+/******************************************************************************/
+void GameStateAsteroidsUpdate(void)
+{
+	// =========================
+	// update according to input
+	// =========================
 
-		// Compute the rotation matrix 
-		AEMtx33Rot(&rot, pInst->dirCurr);
+	// the keys triggered this display frame, only the first step takes them
+	if (g_simStepNum == 0)
+		inputLatch();
 
-		// Compute the translation matrix
-		AEMtx33Trans(&trans, pInst->posCurr.x, pInst->posCurr.y);
+	SimInput input;
+	input.up	= AEInputCheckCurr(AEVK_UP) != 0;
+	input.down	= AEInputCheckCurr(AEVK_DOWN) != 0;
+	input.left	= AEInputCheckCurr(AEVK_LEFT) != 0;
+	input.right	= AEInputCheckCurr(AEVK_RIGHT) != 0;
+	input.fire	= sFireLatched;
 
-		// Concatenate the 3 matrix in the correct order in the object instance's "transform" matrix
-		AEMtx33Concat(&pInst->transform, &rot ,&scale);
+	sFireLatched = false;
 
-		AEMtx33Concat(&pInst->transform, &trans , &pInst->transform);
-	}
+	// spawning, integration, wrap, collision, score and lives, one fixed step
+	SimulationStep(SIM_DT, input);
 
+	// display the game over message once the last ship is lost
+	if (SimulationIsOver())
+		RESTART = true;
 }
 
 /******************************************************************************/
@@ -750,81 +573,73 @@ if(GAMEOVER)
 /******************************************************************************/
 void GameStateAsteroidsDraw(void)
 {
-	char strBuffer[1024];
-	
+	// a press of a frame without a step waits for the next one
+	if (g_simStepNum == 0)
+		inputLatch();
+
 	AEGfxSetRenderMode(AE_GFX_RM_TEXTURE);
 	AEGfxSetBlendMode(AE_GFX_BM_BLEND);
 	AEGfxSetTransparency(1.0f);
 	AEGfxSetTintColor(1.0f, 1.0f, 1.0f, 1.0f);
 
-	// draw all object instances in the list
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst * pInst = sGameObjInstList + i;
+	// collect every sprite and glyph of the frame, in between the last two
+	// steps, then draw them sorted by layer, blend mode and texture, with
+	// one call per run of sprites sharing all three
+	unsigned long instNum;
+	const GameObjInstHot & hot = SimulationGetInstances(instNum);
+
+	// asteroids spawn and wrap outside the window, the batch drops them
+	// until they come in
+	SimBounds view = { AEGfxGetWinMinX(), AEGfxGetWinMinY(), AEGfxGetWinMaxX(), AEGfxGetWinMaxY() };
 
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
+	ProfileZone phase("Sprites");
 
-		// Set the current object instance's transform matrix using "AEGfxSetTransform"
-		AEGfxTextureSet(pInst->pObject->pTex, 0,0);
+	SpriteBatchBegin(view);
+	SpriteBatchAddInstances(hot, instNum, g_simAlpha);
 
-		// Set Transformation
-		AEGfxSetTransform(pInst->transform.m);
+	// the game over panels cover the window, their layer puts them on top
+	bool spawned[] = { SPAWN1, SPAWN2, SPAWN3, SPAWN4 };
 
-		// Draw the shape used by the current object instance using "AEGfxMeshDraw"
-		AEGfxMeshDraw(pInst->pObject->pMesh, AE_GFX_MDM_TRIANGLES);
+	for (unsigned int i = 0; i < sizeof(spawned) / sizeof(spawned[0]); i++)
+	{
+		if (spawned[i])
+			SpriteBatchAdd(TYPE_GAMEOVER1 + i, 0.0f, 0.0f, (float)AEGetWindowWidth(), 0.0f);
 	}
 
+	phase.Next("HUD");
 
+	// the HUD lines, only formatted and measured again when their value changes
+	long shipLives = SimulationGetLives();
 
-	sprintf_s(strBuffer, "Ship Left: %d", sShipLives >= 0 ? sShipLives : 0);
-	AEGfxGetPrintSize(fontId, strBuffer, 1.0f, TextWidth, TextHeight);
-	AEGfxPrint(fontId, strBuffer, 0.99f - TextWidth, 0.99f - TextHeight, 1.0f, 1.f, 1.f, 1.f);
-	
-	sprintf_s(strBuffer, "Score: %d", sScore);
-	AEGfxGetPrintSize(fontId, strBuffer, 1.0f, TextWidth, TextHeight);
-	AEGfxPrint(fontId, strBuffer, 0.66f - TextWidth, 0.99f - TextHeight, 1.0f, 1.f, 1.f, 1.f);
+	const HudText & lives = hudTextUpdate(sHudLives, "Ship Left: %ld", shipLives >= 0 ? shipLives : 0, view);
+	FontPrint(SPRITE_TEXT, lives.text, 0.99f - lives.width, 0.99f - lives.height, 1.0f, view);
 
+	const HudText & score = hudTextUpdate(sHudScore, "Score: %ld", (long)SimulationGetScore(), view);
+	FontPrint(SPRITE_TEXT, score.text, 0.66f - score.width, 0.99f - score.height, 1.0f, view);
+
+	phase.Next("Submit");
+
+	SpriteBatchEnd(spriteBatchFlush);
 
 
 
-	//You can replace this condition/variable by your own data.
-	//The idea is to display any of these variables/strings whenever a change in their value happens
-	static bool onValueChange = true;
-	if(PRINT)
-	{
-		// display the game over message
-		if (sShipLives <= 0)
-		{
-			GAMEOVER = false;
-			RESTART = true;
-		}
 
-		PRINT = false;
-	}
 	if (RESTART) {
 		if (AEInputCheckTriggered(AEVK_RETURN))
 		{
 			gGameStateNext = GS_RESTART;
 		}
 		GAMEOVERTIMER += (float)AEFrameRateControllerGetFrameTime();
-		AEVec2 zero;
-		AEVec2Set(&zero, 0.0f,0.0f);
 		if (GAMEOVERTIMER > 3.0f && !SPAWN4) {
-			gameObjInstCreate(TYPE_GAMEOVER4, (float)AEGetWindowWidth(), &zero, &zero, 0.0f);
 			SPAWN4 = true;
 		}
 		if (GAMEOVERTIMER > 2.0f && !SPAWN3) {
-			gameObjInstCreate(TYPE_GAMEOVER3, (float)AEGetWindowWidth(), &zero, &zero, 0.0f);
 			SPAWN3 = true;
 		}
 		if (GAMEOVERTIMER > 1.0f && !SPAWN2) {
-			gameObjInstCreate(TYPE_GAMEOVER2, (float)AEGetWindowWidth(), &zero, &zero, 0.0f);
 			SPAWN2 = true;
 		}
 		if (GAMEOVERTIMER > 0.5f && !SPAWN1) {
-			gameObjInstCreate(TYPE_GAMEOVER1, (float)AEGetWindowWidth(), &zero, &zero, 0.0f);
 			SPAWN1 = true;
 		}
 	}
@@ -837,18 +652,8 @@ void GameStateAsteroidsDraw(void)
 /******************************************************************************/
 void GameStateAsteroidsFree(void)
 {
-	// kill all object instances in the array using "gameObjInstDestroy"
-
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst* pInst = sGameObjInstList + i;
-
-		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
-			continue;
-
-		gameObjInstDestroy(pInst);
-	}
+	// the object instances stay until Init restarts the round over
+	// the same pool, or Unload frees it
 }
 
 /******************************************************************************/
@@ -858,80 +663,29 @@ void GameStateAsteroidsFree(void)
 /******************************************************************************/
 void GameStateAsteroidsUnload(void)
 {
+	// kill all object instances of the simulation and free its pool
+	SimulationFree();
+
 	// free all mesh data (shapes) of each object using "AEGfxTriFree"
 	//AEGfxMeshFree(_mesh);
 	//AEGfxTextureUnload(_texture);
 
 
 
-	for (unsigned long i = 0; i < sGameObjNum; i++)
-	{
-		GameObj* pObj = sGameObjList + i;
-		AEGfxMeshFree(pObj->pMesh);
-		AEGfxTextureUnload(pObj->pTex);
-	}
+	for (unsigned int i = 0; i < SPRITE_BATCH_RUN_MAX; i++)
+		spriteBatchMeshRelease(i);
+
+	sBatchMeshList.clear();
+
+	// the next state may use them too, the cache unloads them after its load
+	for (unsigned int i = 0; i < sTextureNum; i++)
+		AssetTextureRelease(sTextureList[i]);
 
 	/*AEGfxTextureUnload(pObj_Asteroid->pTex);
 	AEGfxTextureUnload(pObj_Ship->pTex);
 	AEGfxTextureUnload(pObj_Bullet->pTex);*/
 	
 
-	AEGfxDestroyFont(fontId);
+	FontUnload();
 	
 }
-
-/******************************************************************************/
-/*!
-	
-*/
-/******************************************************************************/
-GameObjInst * gameObjInstCreate(unsigned long type, 
-							   float scale, 
-							   AEVec2 * pPos, 
-							   AEVec2 * pVel, 
-							   float dir)
-{
-	AEVec2 zero;
-	AEVec2Zero(&zero);
-
-	AE_ASSERT_PARM(type < sGameObjNum);
-	
-	// loop through the object instance list to find a non-used object instance
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-	{
-		GameObjInst * pInst = sGameObjInstList + i;
-
-		// check if current instance is not used
-		if (pInst->flag == 0)
-		{
-			// it is not used => use it to create the new instance
-			pInst->pObject	= sGameObjList + type;
-			pInst->flag		= FLAG_ACTIVE;
-			pInst->scale	= scale;
-			pInst->posCurr	= pPos ? *pPos : zero;
-			pInst->velCurr	= pVel ? *pVel : zero;
-			pInst->dirCurr	= dir;
-			
-			// return the newly created instance
-			return pInst;
-		}
-	}
-
-	// cannot find empty slot => return 0
-	return 0;
-}
-
-/******************************************************************************/
-/*!
-	
-*/
-/******************************************************************************/
-void gameObjInstDestroy(GameObjInst * pInst)
-{
-	// if instance is destroyed before, just return
-	if (pInst->flag == 0)
-		return;
-
-	// zero out the flag
-	pInst->flag = 0;
-}
\ No newline at end of file
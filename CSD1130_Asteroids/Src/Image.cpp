@@ -0,0 +1,591 @@
+/* Start Header **************************************************************/
+/*!
+\file	Image.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file implements the PNG decoder, inflate included, and the
+background image loader. Each loading image gets a thread of its own:
+the game loads two at a time, a pool would not pay for itself.
+
+The inflate decodes the Huffman codes with a table of their first
+INFLATE_FAST_BITS bits, the longer codes are finished bit by bit.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Image.h"
+#include "Profile.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	INFLATE_CODE_BITS_MAX	= 15;	// longest Huffman code of a deflate stream
+const unsigned int	INFLATE_FAST_BITS		= 9;	// bits decoded by one table lookup
+const unsigned int	INFLATE_LITERAL_NUM		= 288;	// literal/length alphabet
+const unsigned int	INFLATE_DISTANCE_NUM	= 32;	// distance alphabet
+const unsigned int	PNG_SIZE_MAX			= 16384;	// widest and tallest image taken, its buffers fit a 32 bit size_t
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+// canonical Huffman code
+struct InflateHuffman
+{
+	unsigned short			count[INFLATE_CODE_BITS_MAX + 1];	// codes of each length
+	unsigned short			symbol[INFLATE_LITERAL_NUM];		// symbols by code
+	unsigned short			fast[1 << INFLATE_FAST_BITS];		// symbol << 4 | length of the code the bits start with, 0 if longer
+};
+
+struct InflateStream
+{
+	const unsigned char *		pIn;
+	size_t						inSize;
+	size_t						inPos;
+	unsigned int				bitBuffer;
+	unsigned int				bitNum;
+	std::vector<unsigned char> *	pOut;
+	bool						error;
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static const unsigned short		sLengthBase[29]		= { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+														35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned short		sLengthExtra[29]	= { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+														3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short		sDistanceBase[30]	= { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+														257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+														8193, 12289, 16385, 24577 };
+static const unsigned short		sDistanceExtra[30]	= { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+														7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// order the code length code lengths of a dynamic block come in
+static const unsigned char		sCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// codes of the fixed Huffman blocks, built once and only read after,
+// the loader threads share them
+static InflateHuffman			sFixedLiterals;
+static InflateHuffman			sFixedDistances;
+static std::once_flag			sFixedOnce;
+
+static std::thread				sLoaderThreads[IMAGE_LOADER_SLOT_MAX];
+static Image					sLoaderImages[IMAGE_LOADER_SLOT_MAX];
+static bool						sLoaderDone[IMAGE_LOADER_SLOT_MAX];	// decoded, written by the slot's thread before it ends
+
+/******************************************************************************/
+/*!
+	Next "num" bits of the stream, least significant first
+*/
+/******************************************************************************/
+static unsigned int inflateBits(InflateStream & s, unsigned int num)
+{
+	while (s.bitNum < num)
+	{
+		if (s.inPos >= s.inSize)
+		{
+			s.error = true;
+			return 0;
+		}
+
+		s.bitBuffer |= (unsigned int)s.pIn[s.inPos++] << s.bitNum;
+		s.bitNum += 8;
+	}
+
+	unsigned int bits = s.bitBuffer & ((1u << num) - 1);
+	s.bitBuffer >>= num;
+	s.bitNum -= num;
+
+	return bits;
+}
+
+/******************************************************************************/
+/*!
+	Builds the code of "num" symbols from their code lengths. Returns
+	false if the lengths do not make a code
+*/
+/******************************************************************************/
+static bool inflateBuild(InflateHuffman & h, const unsigned char * pLengths, unsigned int num)
+{
+	memset(h.count, 0, sizeof(h.count));
+	memset(h.fast, 0, sizeof(h.fast));
+
+	for (unsigned int i = 0; i < num; i++)
+		h.count[pLengths[i]]++;
+
+	h.count[0] = 0;
+
+	unsigned short offset[INFLATE_CODE_BITS_MAX + 1];
+	offset[1] = 0;
+	for (unsigned int len = 1; len < INFLATE_CODE_BITS_MAX; len++)
+		offset[len + 1] = offset[len] + h.count[len];
+
+	// over-subscribed lengths are no code, incomplete ones are allowed
+	int left = 1;
+	for (unsigned int len = 1; len <= INFLATE_CODE_BITS_MAX; len++)
+	{
+		left = (left << 1) - h.count[len];
+		if (left < 0)
+			return false;
+	}
+
+	for (unsigned int i = 0; i < num; i++)
+	{
+		if (pLengths[i])
+			h.symbol[offset[pLengths[i]]++] = (unsigned short)i;
+	}
+
+	// the short codes, bit reversed since the stream sends them first bit first
+	unsigned int code = 0, index = 0;
+	for (unsigned int len = 1; len <= INFLATE_FAST_BITS; len++)
+	{
+		for (unsigned int k = 0; k < h.count[len]; k++, code++, index++)
+		{
+			unsigned int reversed = 0;
+			for (unsigned int b = 0; b < len; b++)
+				reversed |= ((code >> b) & 1) << (len - 1 - b);
+
+			for (unsigned int fill = reversed; fill < (1u << INFLATE_FAST_BITS); fill += 1u << len)
+				h.fast[fill] = (unsigned short)(h.symbol[index] << 4 | len);
+		}
+		code <<= 1;
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Next symbol of the stream in code "h"
+*/
+/******************************************************************************/
+static unsigned int inflateDecode(InflateStream & s, const InflateHuffman & h)
+{
+	// enough bits for the table, unless the stream ends sooner
+	while (s.bitNum < INFLATE_FAST_BITS && s.inPos < s.inSize)
+	{
+		s.bitBuffer |= (unsigned int)s.pIn[s.inPos++] << s.bitNum;
+		s.bitNum += 8;
+	}
+
+	unsigned int entry = h.fast[s.bitBuffer & ((1u << INFLATE_FAST_BITS) - 1)];
+	if (entry && (entry & 15) <= s.bitNum)
+	{
+		s.bitBuffer >>= entry & 15;
+		s.bitNum -= entry & 15;
+		return entry >> 4;
+	}
+
+	// longer code, walk the lengths one bit at a time
+	int code = 0, first = 0, index = 0;
+	for (unsigned int len = 1; len <= INFLATE_CODE_BITS_MAX; len++)
+	{
+		code |= (int)inflateBits(s, 1);
+		int count = h.count[len];
+		if (code - count < first)
+			return h.symbol[index + (code - first)];
+
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	s.error = true;
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+	Literals and copies of a compressed block, up to its end code
+*/
+/******************************************************************************/
+static void inflateCodes(InflateStream & s, const InflateHuffman & literals, const InflateHuffman & distances)
+{
+	std::vector<unsigned char> & out = *s.pOut;
+
+	while (!s.error)
+	{
+		unsigned int symbol = inflateDecode(s, literals);
+
+		if (symbol < 256)
+		{
+			out.push_back((unsigned char)symbol);
+			continue;
+		}
+
+		if (symbol == 256)
+			return;
+
+		symbol -= 257;
+		if (symbol >= 29)
+		{
+			s.error = true;
+			return;
+		}
+
+		unsigned int length		= sLengthBase[symbol] + inflateBits(s, sLengthExtra[symbol]);
+		unsigned int distSymbol	= inflateDecode(s, distances);
+
+		if (distSymbol >= 30)
+		{
+			s.error = true;
+			return;
+		}
+
+		size_t distance = sDistanceBase[distSymbol] + inflateBits(s, sDistanceExtra[distSymbol]);
+		if (distance > out.size())
+		{
+			s.error = true;
+			return;
+		}
+
+		// the copy can overlap what it writes, byte by byte
+		size_t from = out.size() - distance;
+		for (unsigned int k = 0; k < length; k++)
+			out.push_back(out[from + k]);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Builds the codes of the fixed Huffman blocks
+*/
+/******************************************************************************/
+static void inflateBuildFixed(void)
+{
+	unsigned char lengths[INFLATE_LITERAL_NUM];
+	memset(lengths,			8, 144);
+	memset(lengths + 144,	9, 112);
+	memset(lengths + 256,	7, 24);
+	memset(lengths + 280,	8, 8);
+	inflateBuild(sFixedLiterals, lengths, INFLATE_LITERAL_NUM);
+
+	memset(lengths, 5, INFLATE_DISTANCE_NUM);
+	inflateBuild(sFixedDistances, lengths, INFLATE_DISTANCE_NUM);
+}
+
+/******************************************************************************/
+/*!
+	Decompresses a zlib stream into "out". The checksum is not checked,
+	the PNG chunks have their own
+*/
+/******************************************************************************/
+static bool inflateZlib(const unsigned char * pIn, size_t inSize, std::vector<unsigned char> & out)
+{
+	if (inSize < 2 || (pIn[0] & 15) != 8 || ((pIn[0] << 8) | pIn[1]) % 31 != 0 || (pIn[1] & 32))
+		return false;
+
+	InflateStream s = { pIn, inSize, 2, 0, 0, &out, false };
+
+	InflateHuffman literals, distances;
+
+	unsigned int last;
+	do
+	{
+		last = inflateBits(s, 1);
+		unsigned int type = inflateBits(s, 2);
+
+		if (type == 0)
+		{
+			// stored: whole bytes, after the length and its complement
+			s.bitBuffer = 0;
+			s.bitNum	= 0;
+
+			if (s.inPos + 4 > s.inSize)
+				return false;
+
+			unsigned int len	= s.pIn[s.inPos] | (s.pIn[s.inPos + 1] << 8);
+			unsigned int nlen	= s.pIn[s.inPos + 2] | (s.pIn[s.inPos + 3] << 8);
+			s.inPos += 4;
+
+			if ((len ^ 0xFFFF) != nlen || s.inPos + len > s.inSize)
+				return false;
+
+			out.insert(out.end(), s.pIn + s.inPos, s.pIn + s.inPos + len);
+			s.inPos += len;
+		}
+		else if (type == 1)
+		{
+			std::call_once(sFixedOnce, inflateBuildFixed);
+
+			inflateCodes(s, sFixedLiterals, sFixedDistances);
+		}
+		else if (type == 2)
+		{
+			unsigned int literalNum		= inflateBits(s, 5) + 257;
+			unsigned int distanceNum	= inflateBits(s, 5) + 1;
+			unsigned int codeLengthNum	= inflateBits(s, 4) + 4;
+
+			unsigned char lengths[INFLATE_LITERAL_NUM + INFLATE_DISTANCE_NUM];
+			memset(lengths, 0, 19);
+			for (unsigned int i = 0; i < codeLengthNum; i++)
+				lengths[sCodeLengthOrder[i]] = (unsigned char)inflateBits(s, 3);
+
+			InflateHuffman codeLengths;
+			if (!inflateBuild(codeLengths, lengths, 19))
+				return false;
+
+			// the literal and distance code lengths, run length coded
+			unsigned int i = 0;
+			while (i < literalNum + distanceNum && !s.error)
+			{
+				unsigned int symbol = inflateDecode(s, codeLengths);
+				unsigned int repeat = 0, value = 0;
+
+				if (symbol < 16)
+				{
+					lengths[i++] = (unsigned char)symbol;
+					continue;
+				}
+
+				if (symbol == 16)
+				{
+					if (i == 0)
+						return false;
+					value	= lengths[i - 1];
+					repeat	= 3 + inflateBits(s, 2);
+				}
+				else if (symbol == 17)
+					repeat	= 3 + inflateBits(s, 3);
+				else
+					repeat	= 11 + inflateBits(s, 7);
+
+				if (i + repeat > literalNum + distanceNum)
+					return false;
+
+				while (repeat--)
+					lengths[i++] = (unsigned char)value;
+			}
+
+			if (s.error || !inflateBuild(literals, lengths, literalNum) ||
+				!inflateBuild(distances, lengths + literalNum, distanceNum))
+				return false;
+
+			inflateCodes(s, literals, distances);
+		}
+		else
+			return false;
+
+		if (s.error)
+			return false;
+	}
+	while (!last);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Big endian 32 bits
+*/
+/******************************************************************************/
+static unsigned int pngU32(const unsigned char * p)
+{
+	return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3];
+}
+
+/******************************************************************************/
+/*!
+	Paeth predictor of the PNG filters
+*/
+/******************************************************************************/
+static unsigned char pngPaeth(int a, int b, int c)
+{
+	int p	= a + b - c;
+	int pa	= abs(p - a);
+	int pb	= abs(p - b);
+	int pc	= abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return (unsigned char)a;
+
+	return (unsigned char)(pb <= pc ? b : c);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool ImageLoadPng(const char * pFileName, Image & image)
+{
+	PROFILE_ZONE("ImageLoadPng");
+
+	std::ifstream file(pFileName, std::ios::binary);
+	if (!file)
+		return false;
+
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (data.size() < 8 || memcmp(&data[0], signature, 8) != 0)
+		return false;
+
+	unsigned int width = 0, height = 0, channels = 0;
+	std::vector<unsigned char> compressed;
+
+	// the chunks
+	for (size_t pos = 8; pos + 12 <= data.size(); )
+	{
+		unsigned int length = pngU32(&data[pos]);
+		const unsigned char * pType = &data[pos + 4];
+		const unsigned char * pBody = &data[pos + 8];
+
+		if (length > data.size() - pos - 12)
+			return false;
+
+		if (memcmp(pType, "IHDR", 4) == 0)
+		{
+			if (length < 13)
+				return false;
+
+			width	= pngU32(pBody);
+			height	= pngU32(pBody + 4);
+
+			unsigned char depth = pBody[8], color = pBody[9], interlace = pBody[12];
+			channels = (color == 6) ? 4 : (color == 2) ? 3 : 0;
+
+			if (depth != 8 || channels == 0 || interlace != 0 || width == 0 || height == 0)
+				return false;
+
+			// the pixel and filtered row buffers are sized from these
+			if (width > PNG_SIZE_MAX || height > PNG_SIZE_MAX)
+				return false;
+		}
+		else if (memcmp(pType, "IDAT", 4) == 0)
+			compressed.insert(compressed.end(), pBody, pBody + length);
+		else if (memcmp(pType, "IEND", 4) == 0)
+			break;
+
+		pos += 12 + length;
+	}
+
+	if (channels == 0 || compressed.empty())
+		return false;
+
+	size_t stride = (size_t)width * channels;
+
+	std::vector<unsigned char> raw;
+	raw.reserve((stride + 1) * height);
+
+	if (!inflateZlib(&compressed[0], compressed.size(), raw) || raw.size() < (stride + 1) * height)
+		return false;
+
+	image.width		= width;
+	image.height	= height;
+	image.pixels.resize((size_t)width * height * 4);
+
+	// undo the filters row by row, in place, then spread to RGBA
+	for (unsigned int y = 0; y < height; y++)
+	{
+		unsigned char filter		= raw[y * (stride + 1)];
+		unsigned char * pRow		= &raw[y * (stride + 1) + 1];
+		const unsigned char * pUp	= y ? pRow - (stride + 1) : nullptr;
+
+		for (size_t x = 0; x < stride; x++)
+		{
+			int a = (x >= channels) ? pRow[x - channels] : 0;
+			int b = pUp ? pUp[x] : 0;
+			int c = (pUp && x >= channels) ? pUp[x - channels] : 0;
+
+			switch (filter)
+			{
+			case 0:																break;
+			case 1: pRow[x] = (unsigned char)(pRow[x] + a);						break;
+			case 2: pRow[x] = (unsigned char)(pRow[x] + b);						break;
+			case 3: pRow[x] = (unsigned char)(pRow[x] + ((a + b) >> 1));		break;
+			case 4: pRow[x] = (unsigned char)(pRow[x] + pngPaeth(a, b, c));		break;
+			default: return false;
+			}
+		}
+
+		unsigned char * pPixel = &image.pixels[(size_t)y * width * 4];
+
+		if (channels == 4)
+			memcpy(pPixel, pRow, stride);
+		else
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				pPixel[4 * x + 0] = pRow[3 * x + 0];
+				pPixel[4 * x + 1] = pRow[3 * x + 1];
+				pPixel[4 * x + 2] = pRow[3 * x + 2];
+				pPixel[4 * x + 3] = 0xFF;
+			}
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ImageLoaderStart(unsigned int slot, const char * pFileName)
+{
+	AE_ASSERT_PARM(slot < IMAGE_LOADER_SLOT_MAX && pFileName);
+
+	// a slot is used again only once it is waited for
+	ImageLoaderWait(slot);
+
+	sLoaderDone[slot] = false;
+
+	// the thread keeps its own copy of the name
+	std::string fileName(pFileName);
+	sLoaderThreads[slot] = std::thread([slot, fileName]()
+	{
+		ProfileSetThreadName("Image loader");
+		sLoaderDone[slot] = ImageLoadPng(fileName.c_str(), sLoaderImages[slot]);
+	});
+}
+
+/******************************************************************************/
+/*!
+	The join makes what the thread wrote visible to the caller
+*/
+/******************************************************************************/
+Image * ImageLoaderWait(unsigned int slot)
+{
+	AE_ASSERT_PARM(slot < IMAGE_LOADER_SLOT_MAX);
+
+	if (sLoaderThreads[slot].joinable())
+		sLoaderThreads[slot].join();
+
+	return sLoaderDone[slot] ? &sLoaderImages[slot] : nullptr;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ImageLoaderFree(void)
+{
+	for (unsigned int slot = 0; slot < IMAGE_LOADER_SLOT_MAX; slot++)
+	{
+		ImageLoaderWait(slot);
+
+		sLoaderDone[slot] = false;
+		sLoaderImages[slot].pixels.clear();
+		sLoaderImages[slot].pixels.shrink_to_fit();
+	}
+}
@@ -14,12 +14,28 @@ Technology is prohibited.
 
 
 #include "main.h"
+#include "Simulation.h"
+#include "Asset.h"
+#include "Pack.h"
+#include "Profile.h"
 #include <memory>
 
 // ---------------------------------------------------------------------------
 // Globals
 float	 g_dt;
 double	 g_appTime;
+float	 g_simAlpha;
+unsigned int g_simStepNum;
+
+// display time not yet simulated
+static float	sSimAccumulator;
+
+// longest display frame the simulation catches up on, so a stall does
+// not make it run more and more steps
+const float		SIM_FRAME_TIME_MAX	= 0.25f;
+
+// F9 starts a profiler capture and stops it, writing it here (see Profile.h)
+const char *	PROFILE_FILE		= "Profile.json";
 
 
 /******************************************************************************/
@@ -49,8 +65,14 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
 	//set background color
 	AEGfxSetBackgroundColor(0.53f,0.81f, 0.98f);
 
+	// the decoded images, made by Tools/AssetPack.py. Without it the
+	// textures are decoded from their PNG
+	PackOpen("../Resources/Assets.pak");
+
 	GameStateMgrInit(GS_ASTEROIDS);
 
+	ProfileSetThreadName("Main");
+
 	while(gGameStateCurr != GS_QUIT)
 	{
 		// reset the system modules
@@ -59,8 +81,13 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
 		// If not restarting, load the gamestate
 		if(gGameStateCurr != GS_RESTART)
 		{
+			PROFILE_ZONE("GameStateLoad");
+
 			GameStateMgrUpdate();
 			GameStateLoad();
+
+			// what the last state used and this one did not
+			AssetCollect();
 		}
 		else
 			gGameStateNext = gGameStateCurr = gGameStatePrev;
@@ -68,16 +95,52 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
 		// Initialize the gamestate
 		GameStateInit();
 
+		sSimAccumulator = 0.0f;
+
 		while(gGameStateCurr == gGameStateNext)
 		{
+			PROFILE_ZONE("Frame");
+
 			AESysFrameStart();
 
+			// the input is sampled once per display frame, whatever the number of
+			// steps, so the keys triggered this frame stay triggered until its end
+			ProfileZone phase("AEInputUpdate");
 			AEInputUpdate();
 
-			GameStateUpdate();
+			if (AEInputCheckTriggered(AEVK_F9))
+			{
+				if (!ProfileIsCapturing())
+					ProfileStart();
+				else
+				{
+					ProfileStop();
+					ProfileExport(PROFILE_FILE);
+				}
+			}
+
+			// run the simulation in fixed steps, as many as the display time calls for.
+			// The state holds the triggered keys for the first step, see g_simStepNum
+			sSimAccumulator += min(g_dt, SIM_FRAME_TIME_MAX);
+			g_simStepNum = 0;
+
+			phase.Next("GameStateUpdate");
+
+			while (sSimAccumulator >= SIM_DT && gGameStateCurr == gGameStateNext)
+			{
+				GameStateUpdate();
 
+				sSimAccumulator -= SIM_DT;
+				g_simStepNum++;
+			}
+
+			// draw in between the last two steps
+			g_simAlpha = sSimAccumulator / SIM_DT;
+
+			phase.Next("GameStateDraw");
 			GameStateDraw();
 			
+			phase.Next("AESysFrameEnd");
 			AESysFrameEnd();
 
 			// check if forcing the application to quit
@@ -97,6 +160,10 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
 		gGameStateCurr = gGameStateNext;
 	}
 
+	// every state is unloaded, nothing is held any more
+	AssetCollect();
+	PackClose();
+
 	// free the system
 	AESysExit();
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+/* Start Header **************************************************************/
+/*!
+\file	Pack.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file maps the asset pack written by Tools/AssetPack.py. It is
+little-endian, like the machines the game runs on:
+
+	header		"AEPK", version, image count, 0						4 x u32
+	contents	per image: name (64 bytes, zero padded), offset,
+				width, height, 0
+	pixels		per image: RGBA, top row first, page aligned
+
+The contents are checked against the size of the file once, when it is
+opened; PackFind then only compares names.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Pack.h"
+#include <string>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	PACK_VERSION			= 1;
+const unsigned int	PACK_HEADER_SIZE		= 16;
+const unsigned int	PACK_NAME_SIZE			= 64;
+const unsigned int	PACK_ENTRY_SIZE			= PACK_NAME_SIZE + 16;
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static const unsigned char *	sPackData;			// the mapping, 0 when no pack is open
+static size_t					sPackSize;
+static unsigned int				sPackImageNum;
+static std::string				sPackDir;			// the names are relative to it
+
+#if defined(_WIN32)
+static HANDLE					sPackFile		= INVALID_HANDLE_VALUE;
+static HANDLE					sPackMapping;
+#endif
+
+/******************************************************************************/
+/*!
+	u32 at "offset" in the pack
+*/
+/******************************************************************************/
+static unsigned int packRead(size_t offset)
+{
+	unsigned int value;
+	memcpy(&value, sPackData + offset, sizeof(value));
+
+	return value;
+}
+
+/******************************************************************************/
+/*!
+	Maps the whole file read only. Returns false if it cannot
+*/
+/******************************************************************************/
+static bool packMap(const char * pFileName)
+{
+#if defined(_WIN32)
+	sPackFile = CreateFileA(pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (sPackFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(sPackFile, &size) || size.QuadPart == 0)
+		return false;
+
+	sPackMapping = CreateFileMappingA(sPackFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!sPackMapping)
+		return false;
+
+	sPackData = (const unsigned char *)MapViewOfFile(sPackMapping, FILE_MAP_READ, 0, 0, 0);
+	sPackSize = (size_t)size.QuadPart;
+#else
+	int file = open(pFileName, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// the mapping stays when the file is closed
+	void * pData = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (pData == MAP_FAILED)
+		return false;
+
+	sPackData = (const unsigned char *)pData;
+	sPackSize = (size_t)status.st_size;
+#endif
+
+	return sPackData != nullptr;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool PackOpen(const char * pFileName)
+{
+	AE_ASSERT_PARM(pFileName);
+
+	PackClose();
+
+	if (!packMap(pFileName))
+	{
+		PackClose();
+		return false;
+	}
+
+	bool valid = sPackSize >= PACK_HEADER_SIZE &&
+				 memcmp(sPackData, "AEPK", 4) == 0 && packRead(4) == PACK_VERSION;
+
+	if (valid)
+	{
+		sPackImageNum	= packRead(8);
+		valid			= sPackImageNum <= (sPackSize - PACK_HEADER_SIZE) / PACK_ENTRY_SIZE;
+	}
+
+	// every image must be in the file, and its name end in it
+	for (unsigned int i = 0; valid && i < sPackImageNum; i++)
+	{
+		size_t entry	= PACK_HEADER_SIZE + (size_t)i * PACK_ENTRY_SIZE;
+		size_t offset	= packRead(entry + PACK_NAME_SIZE);
+		size_t size		= (size_t)packRead(entry + PACK_NAME_SIZE + 4) * packRead(entry + PACK_NAME_SIZE + 8) * 4;
+
+		valid = sPackData[entry + PACK_NAME_SIZE - 1] == 0 && offset <= sPackSize && size <= sPackSize - offset;
+	}
+
+	if (!valid)
+	{
+		PackClose();
+		return false;
+	}
+
+	// the images sit next to the pack
+	sPackDir = pFileName;
+	size_t slash = sPackDir.find_last_of("/\\");
+	sPackDir = (slash == std::string::npos) ? std::string() : sPackDir.substr(0, slash + 1);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	The name is matched after the pack's directory, with either slash
+*/
+/******************************************************************************/
+bool PackFind(const char * pFileName, PackImage & image)
+{
+	AE_ASSERT_PARM(pFileName);
+
+	if (!sPackData || strncmp(pFileName, sPackDir.c_str(), sPackDir.size()) != 0)
+		return false;
+
+	const char * pName = pFileName + sPackDir.size();
+
+	for (unsigned int i = 0; i < sPackImageNum; i++)
+	{
+		size_t entry = PACK_HEADER_SIZE + (size_t)i * PACK_ENTRY_SIZE;
+		const char * pEntryName = (const char *)sPackData + entry;
+
+		unsigned int c = 0;
+		while (pEntryName[c] && (pName[c] == pEntryName[c] || (pName[c] == '\\' && pEntryName[c] == '/')))
+			c++;
+
+		if (pEntryName[c] || pName[c])
+			continue;
+
+		image.width		= packRead(entry + PACK_NAME_SIZE + 4);
+		image.height	= packRead(entry + PACK_NAME_SIZE + 8);
+		image.pPixels	= sPackData + packRead(entry + PACK_NAME_SIZE);
+
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PackClose(void)
+{
+#if defined(_WIN32)
+	if (sPackData)
+		UnmapViewOfFile(sPackData);
+	if (sPackMapping)
+		CloseHandle(sPackMapping);
+	if (sPackFile != INVALID_HANDLE_VALUE)
+		CloseHandle(sPackFile);
+
+	sPackMapping	= NULL;
+	sPackFile		= INVALID_HANDLE_VALUE;
+#else
+	if (sPackData)
+		munmap((void *)sPackData, sPackSize);
+#endif
+
+	sPackData		= nullptr;
+	sPackSize		= 0;
+	sPackImageNum	= 0;
+	sPackDir.clear();
+}
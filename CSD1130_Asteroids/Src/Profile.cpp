@@ -0,0 +1,323 @@
+/* Start Header **************************************************************/
+/*!
+\file	Profile.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file records the profiler's zones. A thread takes a ring from the
+table on its first zone and gives it back when it ends, so the short
+lived loader threads reuse the same few rings; only the owner writes in
+a ring, without a lock. The export therefore reads only the caller's
+ring and the rings given back, under the table's lock, which keeps them
+from being taken again meanwhile. A capture start does not touch the
+rings: it bumps a generation number, and a ring from an older generation
+starts over on its next zone.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Profile.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct ProfileEvent
+{
+	const char *				pName;
+	long long					begin;			// in ns from the capture start
+	long long					end;
+};
+
+struct ProfileThread
+{
+	std::vector<ProfileEvent>	events;			// PROFILE_RING_SIZE of them
+	unsigned long				writeNum;		// zones recorded, the ring holds the last ones
+	unsigned long				generation;		// capture the zones belong to
+	bool						live;			// a thread records in it
+	std::string					name;
+};
+
+// gives the ring back when its thread ends
+struct ProfileThreadHandle
+{
+								~ProfileThreadHandle(void);
+
+	ProfileThread *				pThread;
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+static ProfileThread						sProfileThreads[PROFILE_THREAD_MAX];
+static unsigned int							sProfileThreadNum;
+static std::mutex							sProfileMutex;			// guards the table, not the rings
+
+static std::atomic<bool>					sProfileCapturing;
+static std::atomic<unsigned long>			sProfileGeneration;
+static std::atomic<long long>				sProfileStart;			// steady clock in ns, set before the capture flag
+
+static thread_local ProfileThreadHandle		sProfileThreadHandle;
+
+/******************************************************************************/
+/*!
+	The thread is out of its zones, its ring can be exported or taken
+*/
+/******************************************************************************/
+ProfileThreadHandle::~ProfileThreadHandle(void)
+{
+	if (!pThread)
+		return;
+
+	std::lock_guard<std::mutex> lock(sProfileMutex);
+	pThread->live = false;
+}
+
+/******************************************************************************/
+/*!
+	Steady clock, in ns
+*/
+/******************************************************************************/
+static long long profileClock(void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/******************************************************************************/
+/*!
+	Time since the capture start, in ns. The capture flag was read with
+	acquire before, the start is at least the one set with it
+*/
+/******************************************************************************/
+static long long profileNow(void)
+{
+	return profileClock() - sProfileStart.load(std::memory_order_relaxed);
+}
+
+/******************************************************************************/
+/*!
+	Ring of the calling thread, 0 if every ring is taken
+*/
+/******************************************************************************/
+static ProfileThread * profileThread(void)
+{
+	ProfileThreadHandle & handle = sProfileThreadHandle;
+
+	if (handle.pThread)
+		return handle.pThread;
+
+	std::lock_guard<std::mutex> lock(sProfileMutex);
+
+	// a ring given back first, its zones stay until the next capture
+	unsigned int index = 0;
+	while (index < sProfileThreadNum && sProfileThreads[index].live)
+		index++;
+
+	if (index == PROFILE_THREAD_MAX)
+		return nullptr;
+
+	ProfileThread & thread = sProfileThreads[index];
+
+	if (index == sProfileThreadNum)
+	{
+		thread.events.resize(PROFILE_RING_SIZE);
+		thread.writeNum		= 0;
+		thread.generation	= sProfileGeneration.load();
+		thread.name			= "Thread " + std::to_string(index);
+		sProfileThreadNum++;
+	}
+
+	thread.live		= true;
+	handle.pThread	= &thread;
+
+	return &thread;
+}
+
+/******************************************************************************/
+/*!
+	Writes a zone in the calling thread's ring, over the oldest when full
+*/
+/******************************************************************************/
+static void profileRecord(const char * pName, long long begin, long long end)
+{
+	ProfileThread * pThread = profileThread();
+	if (!pThread)
+		return;
+
+	unsigned long generation = sProfileGeneration.load(std::memory_order_relaxed);
+	if (pThread->generation != generation)
+	{
+		pThread->generation	= generation;
+		pThread->writeNum	= 0;
+	}
+
+	ProfileEvent & event = pThread->events[pThread->writeNum % PROFILE_RING_SIZE];
+	event.pName	= pName;
+	event.begin	= begin;
+	event.end	= end;
+
+	pThread->writeNum++;
+}
+
+/******************************************************************************/
+/*!
+	Reads the clock only while a capture runs
+*/
+/******************************************************************************/
+ProfileZone::ProfileZone(const char * pZoneName) :
+	pName(pZoneName),
+	begin(sProfileCapturing.load(std::memory_order_acquire) ? profileNow() : -1)
+{
+}
+
+/******************************************************************************/
+/*!
+	A zone started in a capture is kept even if the capture stopped since
+*/
+/******************************************************************************/
+ProfileZone::~ProfileZone(void)
+{
+	if (begin >= 0)
+		profileRecord(pName, begin, profileNow());
+}
+
+/******************************************************************************/
+/*!
+	One clock read ends this zone and starts the next
+*/
+/******************************************************************************/
+void ProfileZone::Next(const char * pNextName)
+{
+	long long now = -1;
+
+	if (begin >= 0)
+	{
+		now = profileNow();
+		profileRecord(pName, begin, now);
+	}
+
+	pName = pNextName;
+
+	if (!sProfileCapturing.load(std::memory_order_acquire))
+		begin = -1;
+	else
+		begin = (now >= 0) ? now : profileNow();
+}
+
+/******************************************************************************/
+/*!
+	The start time is published by the release of the capture flag
+*/
+/******************************************************************************/
+void ProfileStart(void)
+{
+	sProfileStart.store(profileClock(), std::memory_order_relaxed);
+	sProfileGeneration++;
+	sProfileCapturing.store(true, std::memory_order_release);
+}
+
+/******************************************************************************/
+/*!
+	The zones already started are still recorded when they end
+*/
+/******************************************************************************/
+void ProfileStop(void)
+{
+	sProfileCapturing.store(false, std::memory_order_release);
+}
+
+/******************************************************************************/
+/*!
+	True between ProfileStart and ProfileStop
+*/
+/******************************************************************************/
+bool ProfileIsCapturing(void)
+{
+	return sProfileCapturing.load(std::memory_order_acquire);
+}
+
+/******************************************************************************/
+/*!
+	Takes the thread's ring if it has none yet
+*/
+/******************************************************************************/
+void ProfileSetThreadName(const char * pName)
+{
+	AE_ASSERT_PARM(pName);
+
+	ProfileThread * pThread = profileThread();
+	if (!pThread)
+		return;
+
+	std::lock_guard<std::mutex> lock(sProfileMutex);
+	pThread->name = pName;
+}
+
+/******************************************************************************/
+/*!
+	One "X" (complete) event per zone, in us, and the thread names as
+	metadata. The names are string literals of the code, they are not
+	escaped. A ring another thread still records in is left out: its
+	owner writes it without the lock
+*/
+/******************************************************************************/
+bool ProfileExport(const char * pFileName)
+{
+	AE_ASSERT_PARM(pFileName);
+
+	std::ofstream file(pFileName);
+	if (!file)
+		return false;
+
+	// the caller's own ring, taken before the lock
+	const ProfileThread * pCaller = sProfileThreadHandle.pThread;
+
+	std::lock_guard<std::mutex> lock(sProfileMutex);
+	unsigned long generation = sProfileGeneration.load();
+	const char * pSeparator = "";
+
+	file.setf(std::ios::fixed);
+	file.precision(3);
+	file << "{\"traceEvents\":[\n";
+
+	for (unsigned int t = 0; t < sProfileThreadNum; t++)
+	{
+		const ProfileThread & thread = sProfileThreads[t];
+
+		if ((thread.live && &thread != pCaller) || thread.generation != generation || thread.writeNum == 0)
+			continue;
+
+		file << pSeparator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+			 << ",\"args\":{\"name\":\"" << thread.name << "\"}}";
+		pSeparator = ",\n";
+
+		// the oldest zone still in the ring first
+		unsigned long first = (thread.writeNum > PROFILE_RING_SIZE) ? thread.writeNum - PROFILE_RING_SIZE : 0;
+
+		for (unsigned long i = first; i < thread.writeNum; i++)
+		{
+			const ProfileEvent & event = thread.events[i % PROFILE_RING_SIZE];
+
+			file << ",\n{\"name\":\"" << event.pName << "\",\"ph\":\"X\",\"ts\":" << event.begin * 1.0e-3
+				 << ",\"dur\":" << (event.end - event.begin) * 1.0e-3 << ",\"pid\":1,\"tid\":" << t << "}";
+		}
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return !file.fail();
+}
@@ -0,0 +1,1120 @@
+/* Start Header **************************************************************/
+/*!
+\file	Simulation.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file implements the asteroids simulation: the object instance pool,
+the ship controls, the asteroid spawner, the integration, the wrapping,
+the collisions, the score and the lives.
+
+Nothing here talks to the engine's input, window or frame rate
+controller. The game state turns the keyboard into a SimInput and the
+window into a SimBounds, the headless runner makes them up.
+
+The instances are allocated GAME_OBJ_INST_CHUNK_SIZE at a time as the
+pool grows, and a chunk never moves, so a GameObjInst pointer is good
+for as long as its instance lives, across the creations of a step. The
+packed hot arrays do move when they grow, they are only reached by index.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "Simulation.h"
+#include "Profile.h"
+#include "Collision.h"
+#include "Broadphase.h"
+#include "AABBTree.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	SHIP_INITIAL_NUM		= 3;			// initial number of ship lives
+const float			SHIP_SIZE				= 60.0f;		// ship size
+const float			SHIP_ACCEL_FORWARD		= 90.0f;		// ship forward acceleration (in m/s^2)
+const float			SHIP_ACCEL_BACKWARD		= 180.0f;		// ship backward acceleration (in m/s^2)
+const float			SHIP_ROT_SPEED			= (2.0f * PI);	// ship rotation speed (degree/second)
+const float			SHIP_VEL_DAMPING		= 0.5472f;		// part of its velocity the ship keeps after one second
+
+const float			BULLET_SPEED			= 600.0f;			// bullet speed (m/s)
+const float			BULLET_SIZE				= 15.0f;
+
+const float			ASTEROID_SIZE			= 100.0f;
+const float			ASTEROID_SPEED			= 60.0f;		// asteroid speed (m/s)
+const float			ASTEROID_FRAME_MAX		= 1.0f;			// seconds between two asteroid spawns
+const int			ASTEROID_COUNTER_INIT	= 10;			// asteroids left to spawn at the start of a round
+
+// -----------------------------------------------------------------------------
+// object flag definition
+
+const unsigned long FLAG_ACTIVE				= 0x00000001;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//Game object instance structure
+//The position, velocity, scale and direction live in "GameObjInstHot" and are
+//reached through the gameObjInstPos/Vel/Scale/Dir accessors
+struct GameObjInst
+{
+	unsigned long		type;		// TYPE of the instance
+	unsigned long		flag;		// bit flag or-ed together
+	AABB				boundingBox;// object bouding box that encapsulates the object
+	unsigned long		activeIdx;	// position of this instance in the active list and in "GameObjInstHot"
+	unsigned long		generation;	// bumped on every destroy so stale handles stop resolving
+	int					treeProxy;	// proxy in the AABB tree (asteroids only), AABB_TREE_NULL otherwise
+};
+
+//Candidate asteroids of one bullet/ship, packed for CollisionIntersection_RectRectBatch.
+//The arrays grow to the most candidates a query has had
+struct CollisionBatchBuffer
+{
+	std::vector<float>			minX;	// bounding box of the asteroid
+	std::vector<float>			minY;
+	std::vector<float>			maxX;
+	std::vector<float>			maxY;
+	std::vector<float>			velX;	// velocity of the asteroid
+	std::vector<float>			velY;
+	std::vector<float>			tFirst;	// time of first contact, for the hits
+	std::vector<unsigned int>	slot;	// pool slot of the asteroid
+	std::vector<unsigned int>	hitMask;// one word per 32 candidates
+};
+
+//Storage of "sGameObjInstHot", one entry per slot of the pool
+struct GameObjInstHotArrays
+{
+	std::vector<float>			posX;
+	std::vector<float>			posY;
+	std::vector<float>			velX;
+	std::vector<float>			velY;
+	std::vector<float>			scale;
+	std::vector<float>			dir;
+	std::vector<float>			prevPosX;
+	std::vector<float>			prevPosY;
+	std::vector<float>			prevDir;
+	std::vector<unsigned long>	shapeStamp;
+	std::vector<unsigned long>	type;
+	std::vector<unsigned long>	slot;
+};
+
+//One bullet/ship and asteroid hit found this frame
+struct CollisionEvent
+{
+	float				tFirst;		// time of first contact within the frame
+	unsigned int		queryId;	// slot of the bullet or the ship
+	unsigned int		targetId;	// slot of the asteroid
+};
+
+//Game object instance handle: stays valid across slot reuse, unlike a raw pointer
+struct GameObjInstHandle
+{
+	unsigned long		index;		// slot in the object instance list
+	unsigned long		generation;	// generation of the slot when the handle was taken
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+
+// pool of object instances
+static std::vector<GameObjInst *>	sGameObjInstChunks;					// Slot i is in chunk i / GAME_OBJ_INST_CHUNK_SIZE
+static unsigned long		sGameObjInstSlotNum;						// The number of slots handed to the free list so far
+static unsigned long		sGameObjInstCapacity = GAME_OBJ_INST_NUM_MAX;	// The number of slots the pool may grow to
+static unsigned long		sGameObjInstNum;							// The number of used game object instances
+
+// free list of unused object instance slots
+static std::vector<unsigned long>	sGameObjInstFreeList;				// Stack of slots that are free to use, room for all of them
+
+// packed hot data of the live object instances, the per-frame loops only walk this
+static GameObjInstHot		sGameObjInstHot;							// Entry i belongs to the instance in slot sGameObjInstHot.slot[i]
+static GameObjInstHotArrays	sGameObjInstHotArrays;						// Where the arrays of "sGameObjInstHot" live
+static unsigned long		sGameObjInstActiveNum;						// The number of entries in the active list
+static unsigned long		sGameObjInstShapeStamp;						// Last value given to a "shapeStamp", kept across rounds
+
+// collision broadphase, one entry per slot of the pool
+static unsigned int			sBroadphaseMode = BROADPHASE_GRID;			// BROADPHASE_MODE used by the step
+static std::vector<AABB>	sBroadphaseBoxes;							// swept boxes of the collidable instances
+static std::vector<unsigned int>	sBroadphaseIds;						// slots of the collidable instances
+static std::vector<unsigned char>	sBroadphaseGroups;					// BROADPHASE_GROUP of the collidable instances
+static unsigned int			sBroadphaseNum;								// The number of collidable instances this frame
+static CollisionBatchBuffer	sCollisionBatch;							// Candidates of the query being tested
+static std::vector<CollisionEvent> sCollisionEvents;					// Hits of this frame, resolved in time of impact order
+
+// world and asteroid spawner
+static SimBounds			sBounds;									// world rectangle
+static unsigned int			sRandState;									// state of the spawner's random generator
+static float				sAsteroidFrame;								// seconds left before the next spawn
+static int					sAsteroidCounter;							// asteroids left to spawn
+
+// the ship object
+static GameObjInstHandle	sShipHandle;								// Handle of the "Ship" game object instance
+// number of ship available (lives 0 = game over)
+static long					sShipLives;									// The number of lives left
+
+// the score = number of asteroid destroyed
+static unsigned long		sScore;										// Current score
+
+// ---------------------------------------------------------------------------
+
+// functions to create/destroy a game object instance
+static GameObjInst *		gameObjInstCreate (unsigned long type, float scale,
+											   const AEVec2 * pPos, const AEVec2 * pVel, float dir);
+static void					gameObjInstDestroy(GameObjInst * pInst);
+static void					gameObjInstFlush(void);
+static void					gameObjInstUnlist(unsigned long i);
+static bool					gameObjInstPoolGrow(void);
+static void					gameObjInstPoolReset(void);
+static void					gameObjInstPoolFree(void);
+
+// instance in a slot of the pool
+inline GameObjInst *		gameObjInstAt(unsigned long slot) { return sGameObjInstChunks[slot / GAME_OBJ_INST_CHUNK_SIZE] + slot % GAME_OBJ_INST_CHUNK_SIZE; }
+
+// functions to refer to a game object instance across frames
+static GameObjInstHandle	gameObjInstGetHandle(GameObjInst * pInst);
+static GameObjInst *		gameObjInstFromHandle(GameObjInstHandle handle);
+
+// accessors to the hot fields of a game object instance
+inline float &		gameObjInstPosX (GameObjInst * pInst) { return sGameObjInstHot.posX [pInst->activeIdx]; }
+inline float &		gameObjInstPosY (GameObjInst * pInst) { return sGameObjInstHot.posY [pInst->activeIdx]; }
+inline float &		gameObjInstVelX (GameObjInst * pInst) { return sGameObjInstHot.velX [pInst->activeIdx]; }
+inline float &		gameObjInstVelY (GameObjInst * pInst) { return sGameObjInstHot.velY [pInst->activeIdx]; }
+inline float &		gameObjInstScale(GameObjInst * pInst) { return sGameObjInstHot.scale[pInst->activeIdx]; }
+inline float &		gameObjInstDir  (GameObjInst * pInst) { return sGameObjInstHot.dir  [pInst->activeIdx]; }
+
+// to call after writing the scale or the direction: the renderer keeps
+// what it built from them for as long as the stamp does not change
+inline void			gameObjInstShapeChanged(GameObjInst * pInst) { sGameObjInstHot.shapeStamp[pInst->activeIdx] = ++sGameObjInstShapeStamp; }
+
+inline AEVec2		gameObjInstGetVel(GameObjInst * pInst) { AEVec2 v = { gameObjInstVelX(pInst), gameObjInstVelY(pInst) }; return v; }
+
+// the previous state becomes the current one, nothing to blend for this step
+inline void			gameObjInstTeleport(GameObjInst * pInst)
+{
+	sGameObjInstHot.prevPosX[pInst->activeIdx]	= gameObjInstPosX(pInst);
+	sGameObjInstHot.prevPosY[pInst->activeIdx]	= gameObjInstPosY(pInst);
+	sGameObjInstHot.prevDir [pInst->activeIdx]	= gameObjInstDir(pInst);
+}
+
+/******************************************************************************/
+/*!
+	Same result as AEWrap: x brought back into [x0, x1)
+*/
+/******************************************************************************/
+static float simWrap(float x, float x0, float x1)
+{
+	float range = x1 - x0;
+	return x - range * floorf((x - x0) / range);
+}
+
+/******************************************************************************/
+/*!
+	Random float in [0, 1), from the spawner's own generator so a seed
+	replays the same round
+*/
+/******************************************************************************/
+static float simRandFloat(void)
+{
+	// xorshift32
+	sRandState ^= sRandState << 13;
+	sRandState ^= sRandState >> 17;
+	sRandState ^= sRandState << 5;
+
+	return (float)(sRandState >> 8) * (1.0f / 16777216.0f);
+}
+
+/******************************************************************************/
+/*!
+	Starts a new round
+*/
+/******************************************************************************/
+void SimulationInit(const SimBounds & bounds, unsigned int seed)
+{
+	// No game object instances (sprites) at this point, the pool keeps
+	// the chunks of the last round and allocates more as this one needs
+	gameObjInstPoolReset();
+
+	sBounds		= bounds;
+	sRandState	= seed ? seed : 1;
+
+	// create the main ship
+	GameObjInst * pShip = gameObjInstCreate(TYPE_SHIP, SHIP_SIZE, nullptr, nullptr, 0.0f);
+	AE_ASSERT(pShip);
+	sShipHandle	= gameObjInstGetHandle(pShip);
+
+	// reset the score and the number of ships
+	sScore      = 0;
+	sShipLives  = SHIP_INITIAL_NUM;
+
+	sAsteroidFrame		= ASTEROID_FRAME_MAX;
+	sAsteroidCounter	= ASTEROID_COUNTER_INIT;
+}
+
+#if defined(DEBUG) | defined(_DEBUG)
+/******************************************************************************/
+/*!
+	Debug check of the broadphase against the brute force test: every
+	bullet/ship and asteroid pair the rectangle test accepts must be one
+	of the candidate pairs
+*/
+/******************************************************************************/
+static void broadphaseValidate(const BroadphasePair * pPairs, unsigned int pairNum, float sweepTime)
+{
+	for (unsigned int i = 0; i < sBroadphaseNum; i++)
+	{
+		if (sBroadphaseGroups[i] != BROADPHASE_GROUP_QUERY)
+			continue;
+
+		GameObjInst* pInst = gameObjInstAt(sBroadphaseIds[i]);
+
+		for (unsigned int j = 0; j < sBroadphaseNum; j++)
+		{
+			if (sBroadphaseGroups[j] != BROADPHASE_GROUP_TARGET)
+				continue;
+
+			GameObjInst* pAsteroid = gameObjInstAt(sBroadphaseIds[j]);
+
+			float tFirst;
+			if (!CollisionIntersection_RectRect(pAsteroid->boundingBox, gameObjInstGetVel(pAsteroid), pInst->boundingBox, gameObjInstGetVel(pInst), sweepTime, tFirst))
+				continue;
+
+			// the pairs are sorted by query id then target id
+			unsigned int lo = 0, hi = pairNum;
+			while (lo < hi)
+			{
+				unsigned int mid = (lo + hi) / 2;
+				if (pPairs[mid].queryId < sBroadphaseIds[i] ||
+					(pPairs[mid].queryId == sBroadphaseIds[i] && pPairs[mid].targetId < sBroadphaseIds[j]))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			bool found = lo < pairNum && pPairs[lo].queryId == sBroadphaseIds[i] && pPairs[lo].targetId == sBroadphaseIds[j];
+
+			AE_ASSERT_MESG(found, "broadphase missed a colliding pair!!");
+		}
+	}
+}
+#endif
+
+/******************************************************************************/
+/*!
+	Order of the collision events: time of impact, then slots
+*/
+/******************************************************************************/
+static bool collisionEventLess(const CollisionEvent & a, const CollisionEvent & b)
+{
+	if (a.tFirst != b.tFirst)
+		return a.tFirst < b.tFirst;
+	if (a.queryId != b.queryId)
+		return a.queryId < b.queryId;
+	return a.targetId < b.targetId;
+}
+
+/******************************************************************************/
+/*!
+	Makes room in the collision batch for "candidateNum" asteroids
+*/
+/******************************************************************************/
+static void collisionBatchReserve(unsigned int candidateNum)
+{
+	CollisionBatchBuffer & batch = sCollisionBatch;
+
+	if (batch.slot.size() >= candidateNum)
+		return;
+
+	batch.minX.resize(candidateNum);
+	batch.minY.resize(candidateNum);
+	batch.maxX.resize(candidateNum);
+	batch.maxY.resize(candidateNum);
+	batch.velX.resize(candidateNum);
+	batch.velY.resize(candidateNum);
+	batch.tFirst.resize(candidateNum);
+	batch.slot.resize(candidateNum);
+	batch.hitMask.resize((candidateNum + 31) / 32);
+}
+
+/******************************************************************************/
+/*!
+	Advances the round by one frame
+*/
+/******************************************************************************/
+void SimulationStep(float dt, const SimInput & input)
+{
+	PROFILE_ZONE("SimulationStep");
+
+	// the ship is never destroyed during a round, its handle always resolves
+	GameObjInst * pShip = gameObjInstFromHandle(sShipHandle);
+	AE_ASSERT(pShip);
+
+	// the state before this step, the renderer blends from it
+	GameObjInstHot & hot = sGameObjInstHot;
+
+	for (unsigned long i = 0; i < sGameObjInstActiveNum; i++)
+	{
+		hot.prevPosX[i]	= hot.posX[i];
+		hot.prevPosY[i]	= hot.posY[i];
+		hot.prevDir[i]	= hot.dir[i];
+	}
+
+	// =========================
+	// update according to input
+	// =========================
+
+	// Updating the velocity and position according to acceleration is
+	// done by using the following:
+	// Pos1 = 1/2 * a*t*t + v0*t + Pos0
+	//
+	// In our case we need to divide the previous equation into two parts in order
+	// to have control over the velocity and that is done by:
+	//
+	// v1 = a*t + v0		//This is done when the UP or DOWN key is pressed
+	// Pos1 = v1*t + Pos0
+
+	ProfileZone phase("Input");
+
+	// no more controls nor spawns once the last ship is lost
+	if (!SimulationIsOver())
+	{
+		if (input.up)
+		{
+			// current orientation gives the normalized acceleration vector,
+			// scaled by the full acceleration and by dt: newVel = a*dt + currVel
+			gameObjInstVelX(pShip) += cosf(gameObjInstDir(pShip)) * SHIP_ACCEL_FORWARD * dt;
+			gameObjInstVelY(pShip) += sinf(gameObjInstDir(pShip)) * SHIP_ACCEL_FORWARD * dt;
+		}
+
+		if (input.down)
+		{
+			gameObjInstVelX(pShip) -= cosf(gameObjInstDir(pShip)) * SHIP_ACCEL_BACKWARD * dt;
+			gameObjInstVelY(pShip) -= sinf(gameObjInstDir(pShip)) * SHIP_ACCEL_BACKWARD * dt;
+		}
+
+		if (input.left)
+		{
+			gameObjInstDir(pShip) += SHIP_ROT_SPEED * dt;
+			gameObjInstDir(pShip) =  simWrap(gameObjInstDir(pShip), -PI, PI);
+			gameObjInstShapeChanged(pShip);
+		}
+
+		if (input.right)
+		{
+			gameObjInstDir(pShip) -= SHIP_ROT_SPEED * dt;
+			gameObjInstDir(pShip) =  simWrap(gameObjInstDir(pShip), -PI, PI);
+			gameObjInstShapeChanged(pShip);
+		}
+
+		// Shoot a bullet (Create a new object instance) along the ship's direction,
+		// the shot is lost if the pool is at its capacity
+		if (input.fire)
+		{
+			AEVec2 pos = { gameObjInstPosX(pShip), gameObjInstPosY(pShip) };
+			AEVec2 vel = { cosf(gameObjInstDir(pShip)) * BULLET_SPEED, sinf(gameObjInstDir(pShip)) * BULLET_SPEED };
+
+			gameObjInstCreate(TYPE_BULLET, BULLET_SIZE, &pos, &vel, gameObjInstDir(pShip));
+		}
+
+		phase.Next("Spawn");
+
+		if ((sAsteroidFrame -= dt) < 0)
+		{
+			sAsteroidFrame = ASTEROID_FRAME_MAX;
+
+			if (sAsteroidCounter-- >= 0)
+			{
+				float width		= sBounds.maxX - sBounds.minX;
+				float height	= sBounds.maxY - sBounds.minY;
+
+				float random = simRandFloat();
+				AEVec2 pos;
+				if (simRandFloat() < 0.5f) {
+					// horizontal
+					pos.y = simRandFloat() * height;
+					if (simRandFloat() < 0.5f)
+						pos.x = sBounds.minX - ASTEROID_SIZE;	// negative
+					else
+						pos.x = sBounds.maxX + ASTEROID_SIZE;	// positive
+				}
+				else {
+					// vertical
+					pos.x = simRandFloat() * width;
+					if (simRandFloat() < 0.5f)
+						pos.y = sBounds.minY - ASTEROID_SIZE;
+					else
+						pos.y = sBounds.maxY + ASTEROID_SIZE;
+				}
+				AEVec2 vel = { -cosf(random * 360) * ASTEROID_SPEED, -sinf(random * 360) * ASTEROID_SPEED };
+				pos.x += vel.x * dt;
+				pos.y += vel.y * dt;
+
+				// with the pool at its capacity, the asteroid comes with a later spawn
+				if (!gameObjInstCreate(TYPE_ASTEROID, ASTEROID_SIZE, &pos, &vel, 0.0f))
+					sAsteroidCounter++;
+			}
+		}
+	}
+
+	// ======================================================
+	// update physics of all active game object instances
+	//	-- Positions are updated here with the computed velocity
+	//  -- Get the bounding rectangle of every active instance:
+	//		boundingRect_min = -BOUNDING_RECT_SIZE * instance->scale + instance->pos
+	//		boundingRect_max = BOUNDING_RECT_SIZE * instance->scale + instance->pos
+	// ======================================================
+
+	phase.Next("Broadphase");
+
+	sBroadphaseNum = 0;
+
+	// the swept tests cover the whole step
+	float sweepTime = dt;
+
+	for (unsigned long i = 0; i < sGameObjInstActiveNum; i++)
+	{
+		GameObjInst* pInst = gameObjInstAt(hot.slot[i]);
+
+		// skip non-active object
+		if ((pInst->flag & FLAG_ACTIVE) == 0)
+			continue;
+
+		pInst->boundingBox.min.x = -0.5f * hot.scale[i] + hot.posX[i];
+		pInst->boundingBox.min.y = -0.5f * hot.scale[i] + hot.posY[i];
+		pInst->boundingBox.max.x = 0.5f * hot.scale[i] + hot.posX[i];
+		pInst->boundingBox.max.y = 0.5f * hot.scale[i] + hot.posY[i];
+
+		// bullets and the ship look for the asteroids they can hit,
+		// using where each of them can be during this frame
+		sBroadphaseBoxes[sBroadphaseNum]	= BroadphaseSweptBox(pInst->boundingBox, gameObjInstGetVel(pInst), sweepTime);
+		sBroadphaseIds[sBroadphaseNum]		= hot.slot[i];
+		sBroadphaseGroups[sBroadphaseNum]	= (hot.type[i] == TYPE_ASTEROID) ? BROADPHASE_GROUP_TARGET : BROADPHASE_GROUP_QUERY;
+
+		// the tree only re-inserts the asteroids that left their fat box
+		if (pInst->treeProxy != AABB_TREE_NULL)
+		{
+			AEVec2 displacement = { hot.velX[i] * dt, hot.velY[i] * dt };
+			AABBTreeMoveProxy(pInst->treeProxy, sBroadphaseBoxes[sBroadphaseNum], displacement);
+		}
+
+		sBroadphaseNum++;
+	}
+
+	unsigned int pairNum;
+	const BroadphasePair * pPairs = BroadphaseFindPairs(sBroadphaseMode, sBroadphaseBoxes.data(), sBroadphaseIds.data(),
+														sBroadphaseGroups.data(), sBroadphaseNum, pairNum);
+#if defined(DEBUG) | defined(_DEBUG)
+	broadphaseValidate(pPairs, pairNum, sweepTime);
+#endif
+
+	phase.Next("Collision");
+
+	// the pairs are sorted by query id: test each bullet/ship against all
+	// its candidate asteroids with one batch call and keep every hit
+	CollisionBatchBuffer & batch = sCollisionBatch;
+	sCollisionEvents.clear();
+
+	for (unsigned int p = 0; p < pairNum; )
+	{
+		unsigned int queryId	= pPairs[p].queryId;
+		GameObjInst* pInst		= gameObjInstAt(queryId);
+		unsigned int batchNum	= 0;
+
+		unsigned int groupEnd	= p;
+		while (groupEnd < pairNum && pPairs[groupEnd].queryId == queryId)
+			groupEnd++;
+
+		collisionBatchReserve(groupEnd - p);
+
+		for (; p < groupEnd; p++)
+		{
+			GameObjInst* pAsteroid = gameObjInstAt(pPairs[p].targetId);
+
+			batch.minX[batchNum] = pAsteroid->boundingBox.min.x;
+			batch.minY[batchNum] = pAsteroid->boundingBox.min.y;
+			batch.maxX[batchNum] = pAsteroid->boundingBox.max.x;
+			batch.maxY[batchNum] = pAsteroid->boundingBox.max.y;
+			batch.velX[batchNum] = gameObjInstVelX(pAsteroid);
+			batch.velY[batchNum] = gameObjInstVelY(pAsteroid);
+			batch.slot[batchNum++] = pPairs[p].targetId;
+		}
+
+		AABBBatch boxes = { batch.minX.data(), batch.minY.data(), batch.maxX.data(), batch.maxY.data(),
+							batch.velX.data(), batch.velY.data(), batchNum };
+		unsigned int hitNum = CollisionIntersection_RectRectBatch(pInst->boundingBox, gameObjInstGetVel(pInst), boxes, sweepTime,
+																  batch.hitMask.data(), batch.tFirst.data());
+
+		for (unsigned int k = 0; k < batchNum && hitNum > 0; k++)
+		{
+			if (((batch.hitMask[k / 32] >> (k % 32)) & 1) == 0)
+				continue;
+
+			CollisionEvent hit = { batch.tFirst[k], queryId, batch.slot[k] };
+			sCollisionEvents.push_back(hit);
+			hitNum--;
+		}
+	}
+
+	// resolve the hits by time of impact (slots break the ties), so a bullet
+	// takes the asteroid it reaches first whatever the array layout
+	std::sort(sCollisionEvents.begin(), sCollisionEvents.end(), collisionEventLess);
+
+	bool shipHit = false;
+
+	for (unsigned int e = 0; e < sCollisionEvents.size(); e++)
+	{
+		const CollisionEvent & hit	= sCollisionEvents[e];
+		GameObjInst* pInst			= gameObjInstAt(hit.queryId);
+		GameObjInst* pAsteroid		= gameObjInstAt(hit.targetId);
+
+		// skip the instances destroyed by an earlier hit
+		if ((pInst->flag & FLAG_ACTIVE) == 0 || (pAsteroid->flag & FLAG_ACTIVE) == 0)
+			continue;
+
+		if (pInst->type == TYPE_BULLET)
+		{
+			gameObjInstDestroy(pAsteroid);
+			gameObjInstDestroy(pInst);
+			sScore++;
+			if (sScore >= 5000)
+			{
+				std::cout << "You Rock!" << std::endl;
+			}
+			sAsteroidCounter++;
+		}
+		else
+		{
+			// the ship is sent back to the center on its first hit,
+			// the later hits of this frame did not happen
+			if (shipHit)
+				continue;
+
+			shipHit = true;
+			gameObjInstDestroy(pAsteroid);
+			sShipLives--;
+			gameObjInstPosX(pShip) = 0.0f;
+			gameObjInstPosY(pShip) = 0.0f;
+			gameObjInstVelX(pShip) = 0.0f;
+			gameObjInstVelY(pShip) = 0.0f;
+			gameObjInstTeleport(pShip);
+			sAsteroidCounter++;
+		}
+	}
+
+	phase.Next("Integration");
+
+	// the ship slows down by itself
+	float damping = powf(SHIP_VEL_DAMPING, dt);
+	gameObjInstVelX(pShip) *= damping;
+	gameObjInstVelY(pShip) *= damping;
+
+	// integrate everything straight over the packed arrays, entries
+	// destroyed this step are moved too but get dropped on flush
+	for (unsigned long i = 0; i < sGameObjInstActiveNum; i++)
+	{
+		hot.posX[i] += hot.velX[i] * dt;
+		hot.posY[i] += hot.velY[i] * dt;
+	}
+
+	phase.Next("Wrap");
+
+	// ===================================
+	// update active game object instances
+	//		-- Wrap the ship and the asteroids around the world
+	//		-- Remove the bullets as they go out of bounds
+	// ===================================
+	for (unsigned long i = 0; i < sGameObjInstActiveNum; i++)
+	{
+		GameObjInst * pInst = gameObjInstAt(hot.slot[i]);
+
+		// skip non-active object
+		if ((pInst->flag & FLAG_ACTIVE) == 0)
+			continue;
+
+		// warp the ship and the asteroids from one end of the world to the other,
+		// the previous position jumps along so the interpolation does not streak
+		if (hot.type[i] == TYPE_SHIP || hot.type[i] == TYPE_ASTEROID)
+		{
+			float margin	= (hot.type[i] == TYPE_SHIP) ? SHIP_SIZE : ASTEROID_SIZE;
+			float posX		= simWrap(hot.posX[i], sBounds.minX - margin, sBounds.maxX + margin);
+			float posY		= simWrap(hot.posY[i], sBounds.minY - margin, sBounds.maxY + margin);
+
+			hot.prevPosX[i]	+= posX - hot.posX[i];
+			hot.prevPosY[i]	+= posY - hot.posY[i];
+			hot.posX[i]		= posX;
+			hot.posY[i]		= posY;
+		}
+
+		// Remove bullets that go out of bounds
+		if (hot.type[i] == TYPE_BULLET)
+		{
+			if (hot.posX[i] + BULLET_SIZE <= sBounds.minX || hot.posX[i] - BULLET_SIZE >= sBounds.maxX ||
+				hot.posY[i] + BULLET_SIZE <= sBounds.minY || hot.posY[i] - BULLET_SIZE >= sBounds.maxY)
+			{
+				gameObjInstDestroy(pInst);
+			}
+		}
+	}
+
+	phase.Next("Compact");
+
+	// drop the instances destroyed this frame from the active list
+	gameObjInstFlush();
+}
+
+/******************************************************************************/
+/*!
+	Destroys every object instance of the round
+*/
+/******************************************************************************/
+void SimulationFree(void)
+{
+	// kill all object instances in the array using "gameObjInstDestroy"
+	for (unsigned long i = 0; i < sGameObjInstActiveNum; i++)
+	{
+		GameObjInst* pInst = gameObjInstAt(sGameObjInstHot.slot[i]);
+
+		// skip non-active object
+		if ((pInst->flag & FLAG_ACTIVE) == 0)
+			continue;
+
+		gameObjInstDestroy(pInst);
+	}
+
+	// restart hands out slots in the same order as a fresh round
+	gameObjInstPoolReset();
+	gameObjInstPoolFree();
+}
+
+/******************************************************************************/
+/*!
+	The packed arrays, valid until the next step or spawn grows the pool
+*/
+/******************************************************************************/
+const GameObjInstHot & SimulationGetInstances(unsigned long & instNum)
+{
+	instNum = sGameObjInstActiveNum;
+	return sGameObjInstHot;
+}
+
+/******************************************************************************/
+/*!
+	A bullet points where it goes, like the ones the ship fires
+*/
+/******************************************************************************/
+bool SimulationSpawn(unsigned long type, const AEVec2 & pos, const AEVec2 & vel)
+{
+	AE_ASSERT_PARM(type == TYPE_BULLET || type == TYPE_ASTEROID);
+
+	if (type == TYPE_BULLET)
+		return gameObjInstCreate(TYPE_BULLET, BULLET_SIZE, &pos, &vel, atan2f(vel.y, vel.x)) != 0;
+
+	return gameObjInstCreate(TYPE_ASTEROID, ASTEROID_SIZE, &pos, &vel, 0.0f) != 0;
+}
+
+/******************************************************************************/
+/*!
+	Destroys and unlists at once, there is no step running to flush after
+*/
+/******************************************************************************/
+bool SimulationDespawn(unsigned long index)
+{
+	if (index >= sGameObjInstActiveNum)
+		return false;
+
+	GameObjInst * pInst = gameObjInstAt(sGameObjInstHot.slot[index]);
+
+	// the ship is never destroyed during a round
+	if (pInst->type == TYPE_SHIP)
+		return false;
+
+	gameObjInstDestroy(pInst);
+	gameObjInstUnlist(index);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	A capacity below the slots the pool already has only stops its growth
+*/
+/******************************************************************************/
+void SimulationSetCapacity(unsigned long capacity)
+{
+	AE_ASSERT_PARM(capacity > 0 && capacity <= GAME_OBJ_INST_NUM_MAX);
+	sGameObjInstCapacity = capacity;
+}
+
+/******************************************************************************/
+/*!
+	Counts what the vectors have allocated, not only what they use
+*/
+/******************************************************************************/
+void SimulationGetPoolInfo(SimPoolInfo & info)
+{
+	const GameObjInstHotArrays & arrays = sGameObjInstHotArrays;
+	const CollisionBatchBuffer & batch	= sCollisionBatch;
+
+	info.instNum	= sGameObjInstNum;
+	info.slotNum	= sGameObjInstSlotNum;
+	info.chunkNum	= (unsigned long)sGameObjInstChunks.size();
+	info.capacity	= sGameObjInstCapacity;
+
+	info.bytes	= sGameObjInstChunks.size() * GAME_OBJ_INST_CHUNK_SIZE * sizeof(GameObjInst);
+	info.bytes	+= sGameObjInstChunks.capacity() * sizeof(GameObjInst *);
+	info.bytes	+= sGameObjInstFreeList.capacity() * sizeof(unsigned long);
+
+	info.bytes	+= (arrays.posX.capacity() + arrays.posY.capacity() + arrays.velX.capacity() + arrays.velY.capacity() +
+					arrays.scale.capacity() + arrays.dir.capacity() +
+					arrays.prevPosX.capacity() + arrays.prevPosY.capacity() + arrays.prevDir.capacity()) * sizeof(float);
+	info.bytes	+= (arrays.shapeStamp.capacity() + arrays.type.capacity() + arrays.slot.capacity()) * sizeof(unsigned long);
+
+	info.bytes	+= sBroadphaseBoxes.capacity() * sizeof(AABB);
+	info.bytes	+= sBroadphaseIds.capacity() * sizeof(unsigned int);
+	info.bytes	+= sBroadphaseGroups.capacity() * sizeof(unsigned char);
+
+	info.bytes	+= (batch.minX.capacity() + batch.minY.capacity() + batch.maxX.capacity() + batch.maxY.capacity() +
+					batch.velX.capacity() + batch.velY.capacity() + batch.tFirst.capacity()) * sizeof(float);
+	info.bytes	+= (batch.slot.capacity() + batch.hitMask.capacity()) * sizeof(unsigned int);
+}
+
+/******************************************************************************/
+/*!
+	Broadphase the next steps use, the instances are not touched
+*/
+/******************************************************************************/
+void SimulationSetBroadphaseMode(unsigned int mode)
+{
+	AE_ASSERT_PARM(mode < BROADPHASE_MODE_NUM);
+	sBroadphaseMode = mode;
+}
+
+unsigned int SimulationGetBroadphaseMode(void)
+{
+	return sBroadphaseMode;
+}
+
+/******************************************************************************/
+/*!
+	State of the round, for the HUD and the runners
+*/
+/******************************************************************************/
+long SimulationGetLives(void)
+{
+	return sShipLives;
+}
+
+unsigned long SimulationGetScore(void)
+{
+	return sScore;
+}
+
+bool SimulationIsOver(void)
+{
+	return sShipLives <= 0;
+}
+
+/******************************************************************************/
+/*!
+	Takes a slot off the free list and fills in the instance, 0 if the pool is at its capacity
+*/
+/******************************************************************************/
+static GameObjInst * gameObjInstCreate(unsigned long type,
+									   float scale,
+									   const AEVec2 * pPos,
+									   const AEVec2 * pVel,
+									   float dir)
+{
+	AEVec2 zero = { 0.0f, 0.0f };
+
+	AE_ASSERT_PARM(type < TYPE_SIM_NUM);
+
+	// pop a non-used object instance from the free list, growing the pool
+	// when it is empty; the pool is at its capacity => return 0
+	if (sGameObjInstFreeList.empty() && !gameObjInstPoolGrow())
+		return 0;
+
+	unsigned long i = sGameObjInstFreeList.back();
+	sGameObjInstFreeList.pop_back();
+	GameObjInst * pInst = gameObjInstAt(i);
+
+	// it is not used => use it to create the new instance
+	pInst->type		= type;
+	pInst->flag		= FLAG_ACTIVE;
+
+	sGameObjInstNum++;
+
+	// the per-frame loops reach the instance through the active list
+	pInst->activeIdx = sGameObjInstActiveNum++;
+	sGameObjInstHot.slot[pInst->activeIdx]	= i;
+	sGameObjInstHot.type[pInst->activeIdx]	= type;
+
+	const AEVec2 & pos = pPos ? *pPos : zero;
+	const AEVec2 & vel = pVel ? *pVel : zero;
+
+	gameObjInstScale(pInst)	= scale;
+	gameObjInstPosX(pInst)	= pos.x;
+	gameObjInstPosY(pInst)	= pos.y;
+	gameObjInstVelX(pInst)	= vel.x;
+	gameObjInstVelY(pInst)	= vel.y;
+	gameObjInstDir(pInst)	= dir;
+	gameObjInstShapeChanged(pInst);
+
+	// no previous state yet, it shows up where it is created
+	gameObjInstTeleport(pInst);
+
+	// asteroids live long, they are tracked by the AABB tree
+	pInst->treeProxy = AABB_TREE_NULL;
+	if (type == TYPE_ASTEROID)
+	{
+		AABB box;
+		box.min.x = -0.5f * scale + pos.x;
+		box.min.y = -0.5f * scale + pos.y;
+		box.max.x = 0.5f * scale + pos.x;
+		box.max.y = 0.5f * scale + pos.y;
+
+		pInst->treeProxy = AABBTreeCreateProxy(box, i);
+	}
+
+	// return the newly created instance
+	return pInst;
+}
+
+/******************************************************************************/
+/*!
+	Marks the instance dead, its slot goes back to the free list on the next flush
+*/
+/******************************************************************************/
+static void gameObjInstDestroy(GameObjInst * pInst)
+{
+	// if instance is destroyed before, just return
+	if (pInst->flag == 0)
+		return;
+
+	// zero out the flag
+	pInst->flag = 0;
+	pInst->generation++;
+	sGameObjInstNum--;
+
+	if (pInst->treeProxy != AABB_TREE_NULL)
+	{
+		AABBTreeDestroyProxy(pInst->treeProxy);
+		pInst->treeProxy = AABB_TREE_NULL;
+	}
+
+	// the slot stays in the active list until "gameObjInstFlush" so that
+	// loops walking the list are not disturbed by the removal
+}
+
+/******************************************************************************/
+/*!
+	Swap-remove the destroyed instances from the active list and give
+	their slots back to the free list
+*/
+/******************************************************************************/
+static void gameObjInstFlush(void)
+{
+	unsigned long i = 0;
+
+	while (i < sGameObjInstActiveNum)
+	{
+		// still alive => keep it
+		if (gameObjInstAt(sGameObjInstHot.slot[i])->flag & FLAG_ACTIVE)
+		{
+			i++;
+			continue;
+		}
+
+		// the last entry moves into the hole, look at index i again
+		gameObjInstUnlist(i);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Moves the last entry of the active list over the destroyed instance at
+	index "i" and gives its slot back to the free list
+*/
+/******************************************************************************/
+static void gameObjInstUnlist(unsigned long i)
+{
+	GameObjInstHot & hot = sGameObjInstHot;
+
+	unsigned long slot = hot.slot[i];
+	unsigned long last = --sGameObjInstActiveNum;
+
+	hot.posX[i]		= hot.posX[last];
+	hot.posY[i]		= hot.posY[last];
+	hot.velX[i]		= hot.velX[last];
+	hot.velY[i]		= hot.velY[last];
+	hot.scale[i]	= hot.scale[last];
+	hot.dir[i]		= hot.dir[last];
+	hot.prevPosX[i]	= hot.prevPosX[last];
+	hot.prevPosY[i]	= hot.prevPosY[last];
+	hot.prevDir[i]	= hot.prevDir[last];
+	hot.shapeStamp[i]	= hot.shapeStamp[last];
+	hot.type[i]		= hot.type[last];
+	hot.slot[i]		= hot.slot[last];
+
+	gameObjInstAt(hot.slot[i])->activeIdx = i;
+
+	// the free list has room for every slot, this never allocates
+	sGameObjInstFreeList.push_back(slot);
+}
+
+/******************************************************************************/
+/*!
+	Resizes every array of "sGameObjInstHot" to "slotNum" entries and
+	points it at them again
+*/
+/******************************************************************************/
+static void gameObjInstHotResize(unsigned long slotNum)
+{
+	GameObjInstHotArrays & arrays = sGameObjInstHotArrays;
+	GameObjInstHot & hot = sGameObjInstHot;
+
+	arrays.posX.resize(slotNum);		hot.posX		= arrays.posX.data();
+	arrays.posY.resize(slotNum);		hot.posY		= arrays.posY.data();
+	arrays.velX.resize(slotNum);		hot.velX		= arrays.velX.data();
+	arrays.velY.resize(slotNum);		hot.velY		= arrays.velY.data();
+	arrays.scale.resize(slotNum);		hot.scale		= arrays.scale.data();
+	arrays.dir.resize(slotNum);			hot.dir			= arrays.dir.data();
+	arrays.prevPosX.resize(slotNum);	hot.prevPosX	= arrays.prevPosX.data();
+	arrays.prevPosY.resize(slotNum);	hot.prevPosY	= arrays.prevPosY.data();
+	arrays.prevDir.resize(slotNum);		hot.prevDir		= arrays.prevDir.data();
+	arrays.shapeStamp.resize(slotNum);	hot.shapeStamp	= arrays.shapeStamp.data();
+	arrays.type.resize(slotNum);		hot.type		= arrays.type.data();
+	arrays.slot.resize(slotNum);		hot.slot		= arrays.slot.data();
+
+	hot.slotNum = slotNum;
+}
+
+/******************************************************************************/
+/*!
+	Adds the slots of one more chunk to the free list, or what is left of
+	the last chunk if the capacity was raised. Returns false at capacity
+*/
+/******************************************************************************/
+static bool gameObjInstPoolGrow(void)
+{
+	unsigned long slotNum	= sGameObjInstSlotNum;
+	unsigned long chunkEnd	= (unsigned long)sGameObjInstChunks.size() * GAME_OBJ_INST_CHUNK_SIZE;
+
+	if (slotNum >= sGameObjInstCapacity)
+		return false;
+
+	// a new chunk starts zeroed, like the chunks the reset kept, so the
+	// generations start over with each round: no handle is kept across rounds
+	if (slotNum == chunkEnd)
+	{
+		GameObjInst * pChunk = new GameObjInst[GAME_OBJ_INST_CHUNK_SIZE];
+		memset(pChunk, 0, sizeof(GameObjInst) * GAME_OBJ_INST_CHUNK_SIZE);
+
+		sGameObjInstChunks.push_back(pChunk);
+		chunkEnd += GAME_OBJ_INST_CHUNK_SIZE;
+	}
+
+	unsigned long grownNum = min(chunkEnd, sGameObjInstCapacity);
+
+	// the arrays sized by slot grow with it, by the vectors' own steps
+	gameObjInstHotResize(grownNum);
+	sGameObjInstFreeList.reserve(grownNum);
+	sBroadphaseBoxes.resize(grownNum);
+	sBroadphaseIds.resize(grownNum);
+	sBroadphaseGroups.resize(grownNum);
+
+	// push the slots in reverse so the lowest index is handed out first,
+	// the free list is empty: a round hands them out in the same order
+	// whether the chunks are new or not
+	for (unsigned long i = grownNum; i > slotNum; i--)
+		sGameObjInstFreeList.push_back(i - 1);
+
+	sGameObjInstSlotNum = grownNum;
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Put every slot of the chunks allocated so far back on the free list,
+	the chunks are zeroed like new ones
+*/
+/******************************************************************************/
+static void gameObjInstPoolReset(void)
+{
+	sGameObjInstNum			= 0;
+	sGameObjInstActiveNum	= 0;
+
+	AABBTreeClear();
+
+	for (unsigned int c = 0; c < sGameObjInstChunks.size(); c++)
+		memset(sGameObjInstChunks[c], 0, sizeof(GameObjInst) * GAME_OBJ_INST_CHUNK_SIZE);
+
+	// push the slots in reverse so the lowest index is handed out first
+	sGameObjInstFreeList.clear();
+	for (unsigned long i = sGameObjInstSlotNum; i > 0; i--)
+		sGameObjInstFreeList.push_back(i - 1);
+}
+
+/******************************************************************************/
+/*!
+	Gives the chunks back once the pool is reset, the next round grows
+	it again
+*/
+/******************************************************************************/
+static void gameObjInstPoolFree(void)
+{
+	for (unsigned int c = 0; c < sGameObjInstChunks.size(); c++)
+		delete [] sGameObjInstChunks[c];
+
+	sGameObjInstChunks.clear();
+	sGameObjInstFreeList.clear();
+	sGameObjInstSlotNum = 0;
+	gameObjInstHotResize(0);
+}
+
+/******************************************************************************/
+/*!
+	Handle of a live instance, to find it again in a later frame
+*/
+/******************************************************************************/
+static GameObjInstHandle gameObjInstGetHandle(GameObjInst * pInst)
+{
+	GameObjInstHandle handle;
+
+	handle.index		= sGameObjInstHot.slot[pInst->activeIdx];
+	handle.generation	= pInst->generation;
+
+	return handle;
+}
+
+/******************************************************************************/
+/*!
+	Return the instance a handle refers to, or 0 if it has been destroyed
+*/
+/******************************************************************************/
+static GameObjInst * gameObjInstFromHandle(GameObjInstHandle handle)
+{
+	if (handle.index >= sGameObjInstSlotNum)
+		return 0;
+
+	GameObjInst * pInst = gameObjInstAt(handle.index);
+
+	if ((pInst->flag & FLAG_ACTIVE) == 0 || pInst->generation != handle.generation)
+		return 0;
+
+	return pInst;
+}
@@ -0,0 +1,663 @@
+/* Start Header **************************************************************/
+/*!
+\file	SpriteBatch.cpp
+\author Jee Jia Min , j.jiamin, and 2002144
+\par	j.jiamin@digipen.edu
+\date	Feb 11, 2021
+\brief
+This file implements the sprite batch. The quads are transformed here,
+on the CPU, into one vertex stream in the order they are added, and each
+gets a command holding its sort key. At the end of the frame the commands
+are sorted with a stable LSD radix sort, 8 bits a pass, and the quads are
+gathered in that order so every run of equal keys is contiguous and drawn
+with the identity transform. A sprite out of the view is dropped before
+any of this. The streams are kept from one frame to the
+next so they only allocate while they grow.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*/
+/* End Header ****************************************************************/
+
+#include "SpriteBatch.h"
+#include "Profile.h"
+#include <vector>
+#include <string.h>
+
+// the transforms are built 4 at a time where SSE2 is there, a frame
+// does not have enough instances to make wider vectors pay
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define SPRITE_TRANSFORM_WIDTH 4
+#else
+	#define SPRITE_TRANSFORM_WIDTH 1
+#endif
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+
+// bit position of each field in the sort key, the first compared is the
+// highest. The low 16 bits are free, the radix sort skips them
+const unsigned int					SORT_KEY_LAYER_SHIFT	= 56;
+const unsigned int					SORT_KEY_BLEND_SHIFT	= 48;
+const unsigned int					SORT_KEY_TEXTURE_SHIFT	= 32;
+const unsigned int					SORT_KEY_MESH_SHIFT		= 16;
+
+const unsigned int					SORT_RADIX_BITS			= 8;
+const unsigned int					SORT_RADIX_BUCKETS		= 1 << SORT_RADIX_BITS;
+const unsigned int					SORT_KEY_BITS			= 64;
+
+// half the diagonal of the unit quad: the half size of the box that
+// holds it whatever its rotation
+const float							QUAD_HALF_DIAGONAL		= 0.70710678f;
+
+#if defined(DEBUG) | defined(_DEBUG)
+// largest difference allowed between the batch and the scalar transforms,
+// relative to the scale
+const float							TRANSFORM_TOLERANCE		= 1.0e-5f;
+#endif
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+// texture, rectangle and sort key of each declared sprite
+struct SpriteInfo
+{
+	unsigned int					texture;
+	AtlasRect						rect;
+	unsigned long long				key;
+};
+
+// one queued quad
+struct SpriteCommand
+{
+	unsigned long long				key;
+	unsigned int					quad;		// index of the quad in sQuadVertices
+};
+
+/******************************************************************************/
+/*!
+	Static Variables
+*/
+/******************************************************************************/
+
+// corners of the unit quad in the order of the two triangles, same
+// layout and texture coordinates as the meshes the sprites replace
+static const SpriteVertex			sQuad[SPRITE_BATCH_QUAD_VERTICES] =
+{
+	{ -0.5f, -0.5f, 0.0f, 1.0f },
+	{  0.5f, -0.5f, 1.0f, 1.0f },
+	{ -0.5f,  0.5f, 0.0f, 0.0f },
+
+	{  0.5f, -0.5f, 1.0f, 1.0f },
+	{  0.5f,  0.5f, 1.0f, 0.0f },
+	{ -0.5f,  0.5f, 0.0f, 0.0f },
+};
+
+static SpriteInfo					sSprites[SPRITE_BATCH_SPRITE_MAX];
+
+static std::vector<SpriteVertex>	sQuadVertices;		// quads in the order they were added
+static std::vector<SpriteVertex>	sSortedVertices;	// same quads in key order
+static std::vector<SpriteCommand>	sCommands;
+static std::vector<SpriteCommand>	sCommandsTemp;		// other buffer of the radix sort
+
+static SimBounds					sView;				// what the frame shows
+static unsigned int					sCulledNum;			// sprites dropped out of the view this frame
+
+static unsigned int					sTransformMode		= SPRITE_TRANSFORM_BATCH;
+
+// rotation and scale part of the transform of each instance, by pool
+// slot, built when its shape stamp was "stamp". 0 is never a stamp.
+// It grows with the pool
+struct SpriteTransformCache
+{
+	unsigned long					stamp;
+	float							c, s;
+};
+
+static std::vector<SpriteTransformCache>	sTransformCache;
+static unsigned int					sTransformHitNum;	// transforms of this frame taken from the cache
+static unsigned int					sTransformMissNum;	// and built again
+
+// instances in the view, in order, with their transforms
+static std::vector<unsigned int>	sVisibleSprite;
+static std::vector<SpriteTransform>	sVisibleTransform;
+
+// instances in the view the cache did not have, gathered for the batch
+static std::vector<float>			sMissPosX;
+static std::vector<float>			sMissPosY;
+static std::vector<float>			sMissScale;
+static std::vector<float>			sMissDir;
+static std::vector<unsigned long>	sMissInst;			// index in the instance arrays
+static std::vector<unsigned int>	sMissVisible;		// index in sVisibleTransform
+static std::vector<SpriteTransform>	sMissTransform;
+
+/******************************************************************************/
+/*!
+	Same result as AEWrap: x brought back into [x0, x1)
+*/
+/******************************************************************************/
+static float spriteWrap(float x, float x0, float x1)
+{
+	float range = x1 - x0;
+	return x - range * floorf((x - x0) / range);
+}
+
+/******************************************************************************/
+/*!
+	Stable LSD radix sort of sCommands by key. A pass where every key has
+	the same digit would only copy the commands, so it is skipped: the
+	unused low bits and the fields that do not change in a frame cost
+	one counting loop each.
+*/
+/******************************************************************************/
+static void spriteSortCommands(void)
+{
+	size_t num = sCommands.size();
+
+	sCommandsTemp.resize(num);
+
+	for (unsigned int shift = 0; shift < SORT_KEY_BITS; shift += SORT_RADIX_BITS)
+	{
+		unsigned int count[SORT_RADIX_BUCKETS];
+		memset(count, 0, sizeof(count));
+
+		for (size_t i = 0; i < num; i++)
+			count[(sCommands[i].key >> shift) & (SORT_RADIX_BUCKETS - 1)]++;
+
+		if (count[(sCommands[0].key >> shift) & (SORT_RADIX_BUCKETS - 1)] == num)
+			continue;
+
+		// bucket counts into first positions
+		unsigned int first = 0;
+		for (unsigned int b = 0; b < SORT_RADIX_BUCKETS; b++)
+		{
+			unsigned int n = count[b];
+			count[b] = first;
+			first += n;
+		}
+
+		for (size_t i = 0; i < num; i++)
+			sCommandsTemp[count[(sCommands[i].key >> shift) & (SORT_RADIX_BUCKETS - 1)]++] = sCommands[i];
+
+		sCommands.swap(sCommandsTemp);
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteBatchSetSprite(unsigned int sprite, unsigned int texture, const AtlasRect & rect,
+						  unsigned int layer, unsigned int blend)
+{
+	AE_ASSERT_PARM(sprite < SPRITE_BATCH_SPRITE_MAX);
+	AE_ASSERT_PARM(texture < SPRITE_BATCH_TEXTURE_MAX);
+	AE_ASSERT_PARM(layer < 256 && blend < 256);
+
+	sSprites[sprite].texture	= texture;
+	sSprites[sprite].rect		= rect;
+	sSprites[sprite].key		= ((unsigned long long)layer					<< SORT_KEY_LAYER_SHIFT)
+								| ((unsigned long long)blend					<< SORT_KEY_BLEND_SHIFT)
+								| ((unsigned long long)texture					<< SORT_KEY_TEXTURE_SHIFT)
+								| ((unsigned long long)SPRITE_BATCH_MESH_QUAD	<< SORT_KEY_MESH_SHIFT);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteBatchBegin(const SimBounds & view)
+{
+	sQuadVertices.clear();
+	sCommands.clear();
+
+	sView		= view;
+	sCulledNum	= 0;
+
+	sTransformHitNum	= 0;
+	sTransformMissNum	= 0;
+}
+
+/******************************************************************************/
+/*!
+	True if the sprite's box, at any rotation, is out of the view.
+	It needs neither the sine nor the cosine of the angle
+*/
+/******************************************************************************/
+static bool spriteCull(float posX, float posY, float scale)
+{
+	float half = fabsf(scale) * QUAD_HALF_DIAGONAL;
+
+	if (posX + half < sView.minX || posX - half > sView.maxX ||
+		posY + half < sView.minY || posY - half > sView.maxY)
+	{
+		sCulledNum++;
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************/
+/*!
+	Queues a command for "sprite" and returns the quad to fill in
+*/
+/******************************************************************************/
+static SpriteVertex * spritePush(unsigned int sprite)
+{
+	SpriteCommand command;
+	command.key		= sSprites[sprite].key;
+	command.quad	= (unsigned int)sCommands.size();
+	sCommands.push_back(command);
+
+	size_t first = sQuadVertices.size();
+	sQuadVertices.resize(first + SPRITE_BATCH_QUAD_VERTICES);
+
+	return &sQuadVertices[first];
+}
+
+/******************************************************************************/
+/*!
+	Queues the unit quad of "sprite" through "transform"
+*/
+/******************************************************************************/
+static void spriteEmit(unsigned int sprite, const SpriteTransform & transform)
+{
+	const SpriteInfo & info = sSprites[sprite];
+
+	float du = info.rect.u1 - info.rect.u0;
+	float dv = info.rect.v1 - info.rect.v0;
+
+	SpriteVertex * pVertex = spritePush(sprite);
+
+	for (unsigned int k = 0; k < SPRITE_BATCH_QUAD_VERTICES; k++)
+	{
+		pVertex[k].x = transform.c * sQuad[k].x - transform.s * sQuad[k].y + transform.tx;
+		pVertex[k].y = transform.s * sQuad[k].x + transform.c * sQuad[k].y + transform.ty;
+		pVertex[k].u = info.rect.u0 + sQuad[k].u * du;
+		pVertex[k].v = info.rect.v0 + sQuad[k].v * dv;
+	}
+}
+
+#if SPRITE_TRANSFORM_WIDTH == 4
+/******************************************************************************/
+/*!
+	Sine and cosine of 4 angles. The angles are brought into
+	[-PI/4, PI/4] by a multiple j of PI/2, subtracted in three parts to
+	keep the bits lost on the way out of the result, and the two
+	polynomials of that range are swapped and negated by the quadrant
+	j & 3. Good to a few ulps for angles of a few turns at most, which
+	is what the sprites have
+*/
+/******************************************************************************/
+static inline void sinCos4(__m128 x, __m128 & sinX, __m128 & cosX)
+{
+	__m128i	j		= _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977f)));	// round(x * 2/PI)
+	__m128	jf		= _mm_cvtepi32_ps(j);
+
+	__m128	r		= _mm_sub_ps(x, _mm_mul_ps(jf, _mm_set1_ps(1.5703125f)));
+	r				= _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(4.837512969970703125e-4f)));
+	r				= _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(7.54978995489188216e-8f)));
+	__m128	r2		= _mm_mul_ps(r, r);
+
+	// sin(r) and cos(r) on [-PI/4, PI/4]
+	__m128	ps		= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2), _mm_set1_ps(8.3321608736e-3f));
+	ps				= _mm_add_ps(_mm_mul_ps(ps, r2), _mm_set1_ps(-1.6666654611e-1f));
+	ps				= _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, r2), r), r);
+
+	__m128	pc		= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2), _mm_set1_ps(-1.388731625493765e-3f));
+	pc				= _mm_add_ps(_mm_mul_ps(pc, r2), _mm_set1_ps(4.166664568298827e-2f));
+	pc				= _mm_add_ps(_mm_mul_ps(_mm_mul_ps(pc, r2), r2), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)));
+
+	// odd quadrants swap the two, quadrants 2 and 3 negate the sine,
+	// quadrants 1 and 2 the cosine
+	__m128i	one		= _mm_set1_epi32(1);
+	__m128	swap	= _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+	__m128	signSin	= _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), 30));
+	__m128	signCos	= _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), _mm_set1_epi32(2)), 30));
+
+	sinX = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+	cosX = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+
+	sinX = _mm_xor_ps(sinX, signSin);
+	cosX = _mm_xor_ps(cosX, signCos);
+}
+#endif
+
+#if defined(DEBUG) | defined(_DEBUG)
+/******************************************************************************/
+/*!
+	Checks the batch transforms against SpriteTransformBuild
+*/
+/******************************************************************************/
+static void spriteTransformValidate(unsigned int num)
+{
+	for (unsigned int i = 0; i < num; i++)
+	{
+		SpriteTransform expected = SpriteTransformBuild(sMissPosX[i], sMissPosY[i], sMissScale[i], sMissDir[i]);
+		const SpriteTransform & got = sMissTransform[i];
+
+		float tolerance = TRANSFORM_TOLERANCE * (fabsf(sMissScale[i]) + 1.0f);
+
+		AE_ASSERT_MESG(fabsf(got.c - expected.c) <= tolerance && fabsf(got.s - expected.s) <= tolerance &&
+					   got.tx == expected.tx && got.ty == expected.ty,
+					   "batch transform %u differs from the scalar one!!", i);
+	}
+}
+#endif
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteTransformBuildBatch(const float * pPosX, const float * pPosY, const float * pScale, const float * pDir,
+							   unsigned int num, SpriteTransform * pTransforms)
+{
+	unsigned int i = 0;
+
+#if SPRITE_TRANSFORM_WIDTH == 4
+	for (; i + 4 <= num; i += 4)
+	{
+		__m128 sinDir, cosDir;
+		sinCos4(_mm_loadu_ps(pDir + i), sinDir, cosDir);
+
+		__m128 scale	= _mm_loadu_ps(pScale + i);
+		__m128 c		= _mm_mul_ps(cosDir, scale);
+		__m128 s		= _mm_mul_ps(sinDir, scale);
+		__m128 tx		= _mm_loadu_ps(pPosX + i);
+		__m128 ty		= _mm_loadu_ps(pPosY + i);
+
+		// the 4 fields of 4 transforms, turned into 4 transforms
+		_MM_TRANSPOSE4_PS(c, s, tx, ty);
+
+		float * pOut = &pTransforms[i].c;
+		_mm_storeu_ps(pOut + 0,		c);
+		_mm_storeu_ps(pOut + 4,		s);
+		_mm_storeu_ps(pOut + 8,		tx);
+		_mm_storeu_ps(pOut + 12,	ty);
+	}
+#endif
+
+	for (; i < num; i++)
+		pTransforms[i] = SpriteTransformBuild(pPosX[i], pPosY[i], pScale[i], pDir[i]);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteBatchSetTransformMode(unsigned int mode)
+{
+	AE_ASSERT_PARM(mode < SPRITE_TRANSFORM_MODE_NUM);
+
+	sTransformMode = mode;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int SpriteBatchGetTransformMode(void)
+{
+	return sTransformMode;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteBatchAdd(unsigned int sprite, float posX, float posY, float scale, float dir)
+{
+	AE_ASSERT_PARM(sprite < SPRITE_BATCH_SPRITE_MAX);
+
+	if (spriteCull(posX, posY, scale))
+		return;
+
+	spriteEmit(sprite, SpriteTransformBuild(posX, posY, scale, dir));
+}
+
+/******************************************************************************/
+/*!
+	The rectangle replaces the sprite's own, the state is the sprite's
+*/
+/******************************************************************************/
+void SpriteBatchAddRect(unsigned int sprite, float minX, float minY, float maxX, float maxY, const AtlasRect & rect)
+{
+	AE_ASSERT_PARM(sprite < SPRITE_BATCH_SPRITE_MAX);
+
+	if (maxX < sView.minX || minX > sView.maxX || maxY < sView.minY || minY > sView.maxY)
+	{
+		sCulledNum++;
+		return;
+	}
+
+	float centerX	= 0.5f * (minX + maxX);
+	float centerY	= 0.5f * (minY + maxY);
+	float du		= rect.u1 - rect.u0;
+	float dv		= rect.v1 - rect.v0;
+
+	SpriteVertex * pVertex = spritePush(sprite);
+
+	for (unsigned int k = 0; k < SPRITE_BATCH_QUAD_VERTICES; k++)
+	{
+		pVertex[k].x = centerX + sQuad[k].x * (maxX - minX);
+		pVertex[k].y = centerY + sQuad[k].y * (maxY - minY);
+		pVertex[k].u = rect.u0 + sQuad[k].u * du;
+		pVertex[k].v = rect.v0 + sQuad[k].v * dv;
+	}
+}
+
+/******************************************************************************/
+/*!
+	An instance whose direction is not being blended and whose shape stamp
+	is the one its cached transform was built with only needs its position
+	put in. The others are gathered into arrays and built in one go,
+	one by one or in a batch depending on the transform mode
+*/
+/******************************************************************************/
+void SpriteBatchAddInstances(const GameObjInstHot & hot, unsigned long instNum, float alpha)
+{
+	if (sTransformCache.size() < hot.slotNum)
+		sTransformCache.resize(hot.slotNum);
+
+	sVisibleSprite.resize(instNum);
+	sVisibleTransform.resize(instNum);
+
+	sMissPosX.resize(instNum);
+	sMissPosY.resize(instNum);
+	sMissScale.resize(instNum);
+	sMissDir.resize(instNum);
+	sMissInst.resize(instNum);
+	sMissVisible.resize(instNum);
+
+	unsigned int visibleNum	= 0;
+	unsigned int missNum	= 0;
+
+	ProfileZone phase("Cull");
+
+	for (unsigned long i = 0; i < instNum; i++)
+	{
+		float posX	= hot.prevPosX[i] + (hot.posX[i] - hot.prevPosX[i]) * alpha;
+		float posY	= hot.prevPosY[i] + (hot.posY[i] - hot.prevPosY[i]) * alpha;
+
+		if (spriteCull(posX, posY, hot.scale[i]))
+			continue;
+
+		AE_ASSERT_PARM(hot.type[i] < SPRITE_BATCH_SPRITE_MAX);
+		sVisibleSprite[visibleNum] = (unsigned int)hot.type[i];
+
+		const SpriteTransformCache & cached = sTransformCache[hot.slot[i]];
+
+		if (hot.prevDir[i] == hot.dir[i] && cached.stamp == hot.shapeStamp[i])
+		{
+			SpriteTransform & transform = sVisibleTransform[visibleNum];
+			transform.c		= cached.c;
+			transform.s		= cached.s;
+			transform.tx	= posX;
+			transform.ty	= posY;
+
+#if defined(DEBUG) | defined(_DEBUG)
+			SpriteTransform expected = SpriteTransformBuild(posX, posY, hot.scale[i], hot.dir[i]);
+			float tolerance = TRANSFORM_TOLERANCE * (fabsf(hot.scale[i]) + 1.0f);
+			AE_ASSERT_MESG(fabsf(transform.c - expected.c) <= tolerance && fabsf(transform.s - expected.s) <= tolerance,
+						   "cached transform of slot %lu is stale!!", hot.slot[i]);
+#endif
+		}
+		else
+		{
+			sMissPosX[missNum]		= posX;
+			sMissPosY[missNum]		= posY;
+			sMissScale[missNum]		= hot.scale[i];
+			// the direction is wrapped into [-PI, PI), turn the short way
+			sMissDir[missNum]		= hot.prevDir[i] + spriteWrap(hot.dir[i] - hot.prevDir[i], -PI, PI) * alpha;
+			sMissInst[missNum]		= i;
+			sMissVisible[missNum]	= visibleNum;
+			missNum++;
+		}
+
+		visibleNum++;
+	}
+
+	sTransformHitNum	+= visibleNum - missNum;
+	sTransformMissNum	+= missNum;
+
+	phase.Next("Transforms");
+
+	if (missNum > 0)
+	{
+		sMissTransform.resize(missNum);
+
+		if (sTransformMode == SPRITE_TRANSFORM_BATCH)
+		{
+			SpriteTransformBuildBatch(&sMissPosX[0], &sMissPosY[0], &sMissScale[0], &sMissDir[0],
+									  missNum, &sMissTransform[0]);
+#if defined(DEBUG) | defined(_DEBUG)
+			spriteTransformValidate(missNum);
+#endif
+		}
+		else
+		{
+			for (unsigned int k = 0; k < missNum; k++)
+				sMissTransform[k] = SpriteTransformBuild(sMissPosX[k], sMissPosY[k], sMissScale[k], sMissDir[k]);
+		}
+	}
+
+	for (unsigned int k = 0; k < missNum; k++)
+	{
+		unsigned long i = sMissInst[k];
+		const SpriteTransform & transform = sMissTransform[k];
+
+		sVisibleTransform[sMissVisible[k]] = transform;
+
+		// a blended direction only holds for this frame
+		SpriteTransformCache & cached = sTransformCache[hot.slot[i]];
+		cached.stamp	= (hot.prevDir[i] == hot.dir[i]) ? hot.shapeStamp[i] : 0;
+		cached.c		= transform.c;
+		cached.s		= transform.s;
+	}
+
+	phase.Next("Emit");
+
+	for (unsigned int v = 0; v < visibleNum; v++)
+		spriteEmit(sVisibleSprite[v], sVisibleTransform[v]);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SpriteBatchStats SpriteBatchEnd(SpriteBatchFlushFn pfFlush)
+{
+	SpriteBatchStats stats = { 0, 0, sCulledNum, sTransformHitNum, sTransformMissNum, 0, 0 };
+
+	size_t num = sCommands.size();
+
+	if (num == 0)
+		return stats;
+
+	ProfileZone phase("Sort");
+
+	spriteSortCommands();
+
+	phase.Next("Gather");
+
+	// gather the quads in key order
+	sSortedVertices.resize(num * SPRITE_BATCH_QUAD_VERTICES);
+
+	for (size_t i = 0; i < num; i++)
+		memcpy(&sSortedVertices[i * SPRITE_BATCH_QUAD_VERTICES],
+			   &sQuadVertices[sCommands[i].quad * SPRITE_BATCH_QUAD_VERTICES],
+			   SPRITE_BATCH_QUAD_VERTICES * sizeof(SpriteVertex));
+
+	SpriteBatchState state;
+	memset(&state, 0, sizeof(state));
+
+	phase.Next("Flush");
+
+	// one flush per run of equal keys
+	for (size_t first = 0; first < num; )
+	{
+		unsigned long long key = sCommands[first].key;
+
+		size_t last = first + 1;
+		while (last < num && sCommands[last].key == key)
+			last++;
+
+		SpriteBatchState next;
+		next.layer		= (unsigned int)(key >> SORT_KEY_LAYER_SHIFT)	& 0xFF;
+		next.blend		= (unsigned int)(key >> SORT_KEY_BLEND_SHIFT)	& 0xFF;
+		next.texture	= (unsigned int)(key >> SORT_KEY_TEXTURE_SHIFT)	& 0xFFFF;
+		next.mesh		= (unsigned int)(key >> SORT_KEY_MESH_SHIFT)	& 0xFFFF;
+		next.run		= stats.drawNum;
+		next.changed	= 0;
+
+		if (first == 0 || next.texture != state.texture)
+			next.changed |= SPRITE_BATCH_CHANGE_TEXTURE;
+		if (first == 0 || next.blend != state.blend)
+			next.changed |= SPRITE_BATCH_CHANGE_BLEND;
+
+		state = next;
+
+		pfFlush(state, &sSortedVertices[first * SPRITE_BATCH_QUAD_VERTICES],
+				(unsigned int)((last - first) * SPRITE_BATCH_QUAD_VERTICES));
+
+		stats.drawNum++;
+		stats.spriteNum += (unsigned int)(last - first);
+		if (state.changed & SPRITE_BATCH_CHANGE_TEXTURE)
+			stats.textureChangeNum++;
+		if (state.changed & SPRITE_BATCH_CHANGE_BLEND)
+			stats.blendChangeNum++;
+
+		first = last;
+	}
+
+	return stats;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpriteBatchFlushNull(const SpriteBatchState & state, const SpriteVertex * pVertices, unsigned int vertexNum)
+{
+	UNREFERENCED_PARAMETER(state);
+	UNREFERENCED_PARAMETER(pVertices);
+	UNREFERENCED_PARAMETER(vertexNum);
+}
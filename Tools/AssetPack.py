@@ -0,0 +1,91 @@
+"""Packs the decoded images of the asteroids game into one file.
+
+Finds the images the game loads through the descriptions in Resources
+(the "atlas" line of Textures/*.txt, the "font" line of Fonts/*.txt),
+decodes them and writes their pixels, ready for the texture upload, to:
+
+    Resources/Assets.pak    read by PackOpen (see Pack.h)
+
+The file is little-endian:
+
+    header      "AEPK", version, image count, 0                     4 x u32
+    contents    per image: name (64 bytes, zero padded, relative
+                to Resources, '/' separated), offset, width, height, 0
+    pixels      per image: RGBA, top row first, at an offset that is
+                a multiple of ALIGNMENT
+
+The game falls back on the PNGs when there is no pack, so it only has
+to be run again after changing an image:
+
+    python Tools/AssetPack.py
+
+Only the standard library is used.
+"""
+
+import glob
+import os
+import struct
+import sys
+
+from AtlasPack import read_png
+
+RESOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Resources")
+
+PACK_FILE = "Assets.pak"
+MAGIC     = b"AEPK"
+VERSION   = 1
+NAME_SIZE = 64
+ALIGNMENT = 4096        # a page: every image starts on a page of its own in the mapping
+
+# description directory and the keyword of the line naming its image
+DESCRIPTIONS = [
+    ("Textures", "atlas"),
+    ("Fonts",    "font"),
+]
+
+
+def images():
+    """Names of the images the descriptions refer to, relative to Resources."""
+    names = []
+    for directory, keyword in DESCRIPTIONS:
+        for path in sorted(glob.glob(os.path.join(RESOURCE_DIR, directory, "*.txt"))):
+            with open(path) as f:
+                for line in f:
+                    fields = line.split()
+                    if len(fields) > 1 and fields[0] == keyword:
+                        names.append(directory + "/" + fields[1])
+    return names
+
+
+def align(offset):
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+
+def main():
+    names = images()
+    decoded = [read_png(os.path.join(RESOURCE_DIR, name)) for name in names]
+
+    offset = align(16 + len(names) * (NAME_SIZE + 16))
+    header = struct.pack("<4sIII", MAGIC, VERSION, len(names), 0)
+    contents, offsets = b"", []
+    for name, (width, height, _) in zip(names, decoded):
+        if len(name.encode()) >= NAME_SIZE:
+            sys.exit("%s: name longer than %d bytes" % (name, NAME_SIZE - 1))
+        contents += struct.pack("<%dsIIII" % NAME_SIZE, name.encode(), offset, width, height, 0)
+        offsets.append(offset)
+        offset = align(offset + width * height * 4)
+
+    with open(os.path.join(RESOURCE_DIR, PACK_FILE), "wb") as f:
+        f.write(header + contents)
+        for start, (_, _, rows) in zip(offsets, decoded):
+            f.write(b"\0" * (start - f.tell()))
+            for row in rows:
+                f.write(row)
+
+    for name, (width, height, _) in zip(names, decoded):
+        print("%s: %d x %d" % (name, width, height))
+    print("%s: %d images, %d bytes" % (PACK_FILE, len(names), os.path.getsize(os.path.join(RESOURCE_DIR, PACK_FILE))))
+
+
+if __name__ == "__main__":
+    main()
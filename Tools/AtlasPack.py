@@ -0,0 +1,140 @@
+"""Packs the sprite textures into one atlas for the asteroids game.
+
+Reads the PNGs listed in SPRITES from Resources/Textures, packs them on
+shelves (tallest first) with a transparent border around each one and
+writes:
+
+    Resources/Textures/Atlas.png    the packed image
+    Resources/Textures/Atlas.txt    the pixel rectangle of every sprite,
+                                    read by AtlasLoad (see Atlas.h)
+
+Run it again after changing or adding a sprite:
+
+    python Tools/AtlasPack.py
+
+Only the standard library is used. The decoder handles what the sprites
+are saved as: 8-bit RGBA, non-interlaced.
+"""
+
+import os
+import struct
+import sys
+import zlib
+
+TEXTURE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Resources", "Textures")
+
+# sprite name (as looked up by the game) and source file
+SPRITES = [
+    ("Ship",      "Ship.png"),
+    ("Bullet",    "Bullet.png"),
+    ("Asteroid",  "Asteroid.png"),
+    ("Gameover1", "Gameover1.png"),
+    ("Gameover2", "Gameover2.png"),
+    ("Gameover3", "Gameover3.png"),
+    ("Gameover4", "Gameover4.png"),
+]
+
+ATLAS_WIDTH = 2048      # shelves are filled up to this width
+PADDING     = 2         # transparent pixels around each sprite, against filtering bleed
+
+
+def read_png(path):
+    """Returns (width, height, rows) with rows a list of RGBA bytearrays."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        sys.exit("%s: not a PNG" % path)
+
+    pos, idat = 8, b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+            if depth != 8 or color != 6 or interlace != 0:
+                sys.exit("%s: only 8-bit RGBA non-interlaced PNGs are supported" % path)
+        elif kind == b"IDAT":
+            idat += chunk
+        pos += 12 + length
+
+    raw, stride, bpp = zlib.decompress(idat), width * 4, 4
+    rows, prev = [], bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        kind, row = raw[start], bytearray(raw[start + 1:start + 1 + stride])
+        for x in range(stride):
+            a = row[x - bpp] if x >= bpp else 0
+            b = prev[x]
+            c = prev[x - bpp] if x >= bpp else 0
+            if kind == 1:
+                row[x] = (row[x] + a) & 0xFF
+            elif kind == 2:
+                row[x] = (row[x] + b) & 0xFF
+            elif kind == 3:
+                row[x] = (row[x] + ((a + b) >> 1)) & 0xFF
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                row[x] = (row[x] + pred) & 0xFF
+        rows.append(row)
+        prev = row
+    return width, height, rows
+
+
+def write_png(path, width, height, rows):
+    def chunk(kind, body):
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body) & 0xFFFFFFFF)
+
+    raw = b"".join(b"\x00" + bytes(row) for row in rows)
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def pack(sizes):
+    """Shelf packing, tallest first. Returns the (x, y) of each size and the used height."""
+    order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][1], -sizes[i][0]))
+    places = [None] * len(sizes)
+    shelf_x = shelf_y = shelf_h = 0
+    for i in order:
+        w, h = sizes[i][0] + 2 * PADDING, sizes[i][1] + 2 * PADDING
+        if w > ATLAS_WIDTH:
+            sys.exit("sprite %s is wider than the atlas" % SPRITES[i][0])
+        if shelf_x + w > ATLAS_WIDTH:
+            shelf_x, shelf_y, shelf_h = 0, shelf_y + shelf_h, 0
+        places[i] = (shelf_x + PADDING, shelf_y + PADDING)
+        shelf_x += w
+        shelf_h = max(shelf_h, h)
+    return places, shelf_y + shelf_h
+
+
+def main():
+    images = [read_png(os.path.join(TEXTURE_DIR, file)) for _, file in SPRITES]
+    places, used_height = pack([(w, h) for w, h, _ in images])
+
+    width  = max(x + w + PADDING for (x, _), (w, _, _) in zip(places, images))
+    height = (used_height + 3) & ~3
+
+    atlas = [bytearray(width * 4) for _ in range(height)]
+    for (x, y), (w, h, rows) in zip(places, images):
+        for r in range(h):
+            atlas[y + r][x * 4:(x + w) * 4] = rows[r]
+
+    write_png(os.path.join(TEXTURE_DIR, "Atlas.png"), width, height, atlas)
+
+    with open(os.path.join(TEXTURE_DIR, "Atlas.txt"), "w", newline="\n") as f:
+        f.write("# generated by Tools/AtlasPack.py, do not edit\n")
+        f.write("# atlas <image> <width> <height>, then <sprite> <x> <y> <width> <height> in pixels from the top left\n")
+        f.write("atlas Atlas.png %d %d\n" % (width, height))
+        for (name, _), (x, y), (w, h, _) in zip(SPRITES, places, images):
+            f.write("%s %d %d %d %d\n" % (name, x, y, w, h))
+
+    print("Atlas.png: %d x %d, %d sprites" % (width, height, len(SPRITES)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,339 @@
+"""Rasterizes the HUD font into a glyph atlas for the asteroids game.
+
+Reads FONT_FILE from Resources/Fonts, renders the printable ASCII
+characters at FONT_SIZE pixels per em, packs them on shelves with a
+transparent border around each one and writes, next to the font:
+
+    <font>_<size>.png    the glyphs, white with the coverage in alpha
+    <font>_<size>.txt    the metrics of every glyph, read by FontLoad
+                         (see Font.h)
+
+Run it again after changing the font or its size:
+
+    python Tools/FontPack.py
+
+Only the standard library is used. The reader handles TrueType outlines
+(the "glyf" table), simple and composite glyphs, and format 4 character
+maps. Hinting and kerning are ignored.
+"""
+
+import os
+import struct
+import sys
+
+from AtlasPack import write_png
+
+FONT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Resources", "Fonts")
+
+FONT_FILE   = "Strawberry_Muffins_Demo.ttf"
+FONT_SIZE   = 20            # pixels per em, the size given to AEGfxCreateFont
+CHARACTERS  = range(32, 127)
+
+ATLAS_WIDTH = 256           # shelves are filled up to this width
+PADDING     = 1             # transparent pixels around each glyph, against filtering bleed
+SUPERSAMPLE = 4             # coverage samples per pixel along each axis
+CURVE_STEPS = 8             # line segments per quadratic curve
+
+
+class Font:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = data = f.read()
+
+        if struct.unpack(">I", data[:4])[0] != 0x00010000:
+            sys.exit("%s: not a TrueType font" % path)
+
+        num_tables = struct.unpack(">H", data[4:6])[0]
+        self.tables = {}
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack(">4sIII", data[12 + 16 * i:28 + 16 * i])
+            self.tables[tag.decode("latin-1")] = (offset, length)
+
+        for tag in ("head", "maxp", "hhea", "hmtx", "loca", "glyf", "cmap"):
+            if tag not in self.tables:
+                sys.exit("%s: no %s table" % (path, tag))
+
+        head = self.table("head")
+        self.units_per_em = struct.unpack(">H", head[18:20])[0]
+        loca_long = struct.unpack(">h", head[50:52])[0] == 1
+
+        self.num_glyphs = struct.unpack(">H", self.table("maxp")[4:6])[0]
+
+        hhea = self.table("hhea")
+        self.ascender, self.descender, self.line_gap = struct.unpack(">hhh", hhea[4:10])
+        num_metrics = struct.unpack(">H", hhea[34:36])[0]
+
+        hmtx = self.table("hmtx")
+        self.advances = [struct.unpack(">H", hmtx[4 * i:4 * i + 2])[0] for i in range(num_metrics)]
+
+        loca = self.table("loca")
+        if loca_long:
+            self.loca = struct.unpack(">%dI" % (self.num_glyphs + 1), loca[:4 * (self.num_glyphs + 1)])
+        else:
+            self.loca = [2 * o for o in struct.unpack(">%dH" % (self.num_glyphs + 1), loca[:2 * (self.num_glyphs + 1)])]
+
+        self.cmap = self.read_cmap()
+
+    def table(self, tag):
+        offset, length = self.tables[tag]
+        return self.data[offset:offset + length]
+
+    def read_cmap(self):
+        cmap = self.table("cmap")
+        num = struct.unpack(">H", cmap[2:4])[0]
+        for i in range(num):
+            platform, encoding, offset = struct.unpack(">HHI", cmap[4 + 8 * i:12 + 8 * i])
+            if (platform, encoding) in ((3, 1), (0, 3)) and struct.unpack(">H", cmap[offset:offset + 2])[0] == 4:
+                return self.read_cmap4(cmap, offset)
+        sys.exit("no format 4 unicode character map")
+
+    @staticmethod
+    def read_cmap4(cmap, offset):
+        seg_count = struct.unpack(">H", cmap[offset + 6:offset + 8])[0] // 2
+        ends_at = offset + 14
+        starts_at = ends_at + 2 * seg_count + 2
+        deltas_at = starts_at + 2 * seg_count
+        ranges_at = deltas_at + 2 * seg_count
+
+        def u16(pos):
+            return struct.unpack(">H", cmap[pos:pos + 2])[0]
+
+        mapping = {}
+        for s in range(seg_count):
+            end, start = u16(ends_at + 2 * s), u16(starts_at + 2 * s)
+            delta, range_offset = u16(deltas_at + 2 * s), u16(ranges_at + 2 * s)
+            for code in range(start, end + 1):
+                if code == 0xFFFF:
+                    continue
+                if range_offset == 0:
+                    glyph = (code + delta) & 0xFFFF
+                else:
+                    glyph = u16(ranges_at + 2 * s + range_offset + 2 * (code - start))
+                    glyph = (glyph + delta) & 0xFFFF if glyph else 0
+                mapping[code] = glyph
+        return mapping
+
+    def advance(self, glyph):
+        return self.advances[min(glyph, len(self.advances) - 1)]
+
+    def contours(self, glyph):
+        """Returns the outline of a glyph as lists of (x, y, on_curve) in font units."""
+        start, end = self.loca[glyph], self.loca[glyph + 1]
+        if start == end:
+            return []
+
+        glyf = self.tables["glyf"][0]
+        data = self.data[glyf + start:glyf + end]
+        num_contours = struct.unpack(">h", data[:2])[0]
+
+        if num_contours >= 0:
+            return self.simple_contours(data, num_contours)
+        return self.composite_contours(data)
+
+    @staticmethod
+    def simple_contours(data, num_contours):
+        pos = 10
+        end_points = struct.unpack(">%dH" % num_contours, data[pos:pos + 2 * num_contours])
+        pos += 2 * num_contours
+        pos += 2 + struct.unpack(">H", data[pos:pos + 2])[0]
+        num_points = end_points[-1] + 1 if num_contours else 0
+
+        flags = []
+        while len(flags) < num_points:
+            flag = data[pos]
+            pos += 1
+            repeat = 0
+            if flag & 8:
+                repeat = data[pos]
+                pos += 1
+            flags.extend([flag] * (repeat + 1))
+
+        def coordinates(short_bit, same_bit):
+            nonlocal pos
+            values, value = [], 0
+            for flag in flags:
+                if flag & short_bit:
+                    delta = data[pos]
+                    pos += 1
+                    value += delta if flag & same_bit else -delta
+                elif not flag & same_bit:
+                    value += struct.unpack(">h", data[pos:pos + 2])[0]
+                    pos += 2
+                values.append(value)
+            return values
+
+        xs = coordinates(2, 16)
+        ys = coordinates(4, 32)
+
+        contours, first = [], 0
+        for last in end_points:
+            contours.append([(xs[i], ys[i], flags[i] & 1) for i in range(first, last + 1)])
+            first = last + 1
+        return contours
+
+    def composite_contours(self, data):
+        contours, pos = [], 10
+        while True:
+            flags, glyph = struct.unpack(">HH", data[pos:pos + 4])
+            pos += 4
+            if flags & 1:
+                dx, dy = struct.unpack(">hh", data[pos:pos + 4])
+                pos += 4
+            else:
+                dx, dy = struct.unpack(">bb", data[pos:pos + 2])
+                pos += 2
+            if not flags & 2:
+                dx = dy = 0     # point matching, not used by the fonts we ship
+
+            a, b, c, d = 1.0, 0.0, 0.0, 1.0
+            if flags & 8:
+                a = d = struct.unpack(">h", data[pos:pos + 2])[0] / 16384.0
+                pos += 2
+            elif flags & 0x40:
+                a, d = [v / 16384.0 for v in struct.unpack(">hh", data[pos:pos + 4])]
+                pos += 4
+            elif flags & 0x80:
+                a, b, c, d = [v / 16384.0 for v in struct.unpack(">hhhh", data[pos:pos + 8])]
+                pos += 8
+
+            for contour in self.contours(glyph):
+                contours.append([(a * x + c * y + dx, b * x + d * y + dy, on) for x, y, on in contour])
+
+            if not flags & 0x20:
+                return contours
+
+
+def flatten(contour, scale):
+    """Turns a contour into a closed polygon in pixels, y up."""
+    points = [(x * scale, y * scale, on) for x, y, on in contour]
+
+    # start on an on-curve point, making one between two off-curve points if needed
+    start = next((i for i, p in enumerate(points) if p[2]), None)
+    if start is None:
+        a, b = points[0], points[1]
+        points.insert(0, ((a[0] + b[0]) / 2, (a[1] + b[1]) / 2, 1))
+        start = 0
+    points = points[start:] + points[:start] + [points[start]]
+
+    polygon, control = [points[0][:2]], None
+    for x, y, on in points[1:]:
+        if on:
+            if control is None:
+                polygon.append((x, y))
+            else:
+                polygon.extend(curve(polygon[-1], control, (x, y)))
+                control = None
+        else:
+            if control is not None:
+                middle = ((control[0] + x) / 2, (control[1] + y) / 2)
+                polygon.extend(curve(polygon[-1], control, middle))
+            control = (x, y)
+    return polygon
+
+
+def curve(p0, p1, p2):
+    points = []
+    for i in range(1, CURVE_STEPS + 1):
+        t = i / CURVE_STEPS
+        u = 1 - t
+        points.append((u * u * p0[0] + 2 * u * t * p1[0] + t * t * p2[0],
+                       u * u * p0[1] + 2 * u * t * p1[1] + t * t * p2[1]))
+    return points
+
+
+def rasterize(polygons, left, top, width, height):
+    """Coverage of the polygons (non-zero rule) over the pixels, rows from the top."""
+    edges = []
+    for polygon in polygons:
+        for (x0, y0), (x1, y1) in zip(polygon, polygon[1:]):
+            if y0 != y1:
+                edges.append((x0, y0, x1, y1, 1 if y1 > y0 else -1))
+
+    samples = SUPERSAMPLE * SUPERSAMPLE
+    rows = []
+    for row in range(height):
+        coverage = [0] * width
+        for sub_row in range(SUPERSAMPLE):
+            y = top - row - (sub_row + 0.5) / SUPERSAMPLE
+            crossings = []
+            for x0, y0, x1, y1, winding in edges:
+                if min(y0, y1) <= y < max(y0, y1):
+                    crossings.append((x0 + (y - y0) * (x1 - x0) / (y1 - y0), winding))
+            crossings.sort()
+
+            inside = 0
+            for (xa, winding), (xb, _) in zip(crossings, crossings[1:] + [(None, 0)]):
+                inside += winding
+                if inside == 0 or xb is None:
+                    continue
+                # sample columns whose centre is in [xa, xb)
+                first = max(0, int(-(-((xa - left) * SUPERSAMPLE - 0.5) // 1)))
+                last = min(width * SUPERSAMPLE, int(-(-((xb - left) * SUPERSAMPLE - 0.5) // 1)))
+                for column in range(first, last):
+                    coverage[column // SUPERSAMPLE] += 1
+        rows.append(bytearray(b for c in coverage for b in (255, 255, 255, min(255, (c * 255 + samples // 2) // samples))))
+    return rows
+
+
+def pack(sizes):
+    """Shelf packing, tallest first. Returns the (x, y) of each size and the used height."""
+    order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][1], -sizes[i][0]))
+    places = [None] * len(sizes)
+    shelf_x = shelf_y = shelf_h = 0
+    for i in order:
+        w, h = sizes[i][0] + 2 * PADDING, sizes[i][1] + 2 * PADDING
+        if shelf_x + w > ATLAS_WIDTH:
+            shelf_x, shelf_y, shelf_h = 0, shelf_y + shelf_h, 0
+        places[i] = (shelf_x + PADDING, shelf_y + PADDING)
+        shelf_x += w
+        shelf_h = max(shelf_h, h)
+    return places, shelf_y + shelf_h
+
+
+def main():
+    font = Font(os.path.join(FONT_DIR, FONT_FILE))
+    scale = FONT_SIZE / font.units_per_em
+
+    glyphs = []
+    for code in CHARACTERS:
+        glyph = font.cmap.get(code, 0)
+        polygons = [flatten(c, scale) for c in font.contours(glyph) if len(c) > 1]
+        advance = int(round(font.advance(glyph) * scale))
+
+        if polygons:
+            xs = [x for p in polygons for x, _ in p]
+            ys = [y for p in polygons for _, y in p]
+            left, right = int(min(xs) // 1), int(-(-max(xs) // 1))
+            bottom, top = int(min(ys) // 1), int(-(-max(ys) // 1))
+            rows = rasterize(polygons, left, top, right - left, top - bottom)
+            glyphs.append((code, left, top, right - left, top - bottom, advance, rows))
+        else:
+            glyphs.append((code, 0, 0, 0, 0, advance, []))
+
+    places, used_height = pack([(g[3], g[4]) for g in glyphs])
+    height = (used_height + 3) & ~3
+
+    atlas = [bytearray(ATLAS_WIDTH * 4) for _ in range(height)]
+    for (x, y), (_, _, _, w, h, _, rows) in zip(places, glyphs):
+        for r in range(h):
+            atlas[y + r][x * 4:(x + w) * 4] = rows[r]
+
+    name = "%s_%d" % (os.path.splitext(FONT_FILE)[0], FONT_SIZE)
+    write_png(os.path.join(FONT_DIR, name + ".png"), ATLAS_WIDTH, height, atlas)
+
+    with open(os.path.join(FONT_DIR, name + ".txt"), "w", newline="\n") as f:
+        f.write("# generated by Tools/FontPack.py from %s, do not edit\n" % FONT_FILE)
+        f.write("# font <image> <width> <height> <size> <ascent> <descent> <line height>, then\n")
+        f.write("# <code> <x> <y> <width> <height> <bearing x> <bearing y> <advance> in pixels,\n")
+        f.write("# x y from the top left of the image, the bearings from the pen on the baseline, y up\n")
+        f.write("font %s.png %d %d %d %d %d %d\n" % (name, ATLAS_WIDTH, height, FONT_SIZE,
+                int(round(font.ascender * scale)), int(round(-font.descender * scale)),
+                int(round((font.ascender - font.descender + font.line_gap) * scale))))
+        for (x, y), (code, left, top, w, h, advance, _) in zip(places, glyphs):
+            f.write("%d %d %d %d %d %d %d %d\n" % (code, x, y, w, h, left, top, advance))
+
+    print("%s.png: %d x %d, %d glyphs" % (name, ATLAS_WIDTH, height, len(glyphs)))
+
+
+if __name__ == "__main__":
+    main()